@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
+
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Размер прозрачной большой страницы (transparent huge page) на x86-64 и AArch64 с 4-КБ страницами
+inline constexpr size_t kHugePageSize = size_t(2) << 20;
+
+// Аллокатор, выравнивающий каждый буфер по Alignment байт (по умолчанию по строке кэша,
+// что достаточно и для загрузок AVX-512). Буферы не меньше HugePageThreshold байт
+// выравниваются по большой странице, дополняются до целого числа больших страниц
+// и помечаются madvise(MADV_HUGEPAGE), чтобы ядро отобразило их большими страницами
+// и гигабайтный вектор занимал в TLB сотни записей, а не сотни тысяч.
+// HugePageThreshold = std::numeric_limits<size_t>::max() отключает большие страницы.
+//
+// Все экземпляры равны, поэтому контейнеры свободно обмениваются буферами
+template <typename Type, size_t Alignment = 64, size_t HugePageThreshold = kHugePageSize>
+struct AlignedAllocator {
+    static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+
+    // Параметры шаблона не являются типами, поэтому allocator_traits не может вывести rebind сам
+    template <typename Other>
+    struct rebind {
+        using other = AlignedAllocator<Other, Alignment, HugePageThreshold>;
+    };
+
+    // Выравнивание обычных буферов
+    static constexpr size_t kAlignment = std::max(Alignment, alignof(Type));
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename Other>
+    AlignedAllocator(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - kHugePageSize) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(Type);
+        if (!IsHuge(bytes)) {
+            return static_cast<Type*>(::operator new(bytes, std::align_val_t(kAlignment)));
+        }
+        const size_t huge_bytes = RoundToHugePages(bytes);
+        void* buffer = ::operator new(huge_bytes, std::align_val_t(std::max(kAlignment, kHugePageSize)));
+#ifdef MADV_HUGEPAGE
+        // Это лишь совет: без поддержки THP буфер остаётся на обычных страницах
+        ::madvise(buffer, huge_bytes, MADV_HUGEPAGE);
+#endif
+        return static_cast<Type*>(buffer);
+    }
+
+    void deallocate(Type* buffer, size_t n) noexcept {
+        const size_t bytes = n * sizeof(Type);
+        if (!IsHuge(bytes)) {
+            ::operator delete(buffer, bytes, std::align_val_t(kAlignment));
+        } else {
+            ::operator delete(buffer, RoundToHugePages(bytes), std::align_val_t(std::max(kAlignment, kHugePageSize)));
+        }
+    }
+
+    // Сообщает, будет ли буфер из bytes байт выделен большими страницами
+    static constexpr bool IsHuge(size_t bytes) noexcept {
+        return bytes >= HugePageThreshold;
+    }
+
+    template <typename Other>
+    bool operator==(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) const noexcept {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!=(const AlignedAllocator<Other, Alignment, HugePageThreshold>&) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr size_t RoundToHugePages(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+};
+
+// SimpleVector, чьи элементы начинаются с адреса, кратного Alignment
+template <typename Type, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>, GrowthPolicy>;
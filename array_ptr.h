@@ -3,6 +3,9 @@
 #include <cassert>
 #include <cstdlib>
 #include <initializer_list>
+#include <utility>
+
+#include "vector_stats.h"
 
 template <typename Type>
 class ArrayPtr {
@@ -17,6 +20,7 @@ public:
             return;
         }
         raw_ptr_ = new Type[size]{};
+        RecordAllocation<Type>(size * sizeof(Type));
     }
 
     // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
@@ -0,0 +1,338 @@
+// Микробенчмарки SimpleVector в сравнении с std::vector.
+//
+// Сборка и запуск:
+//     g++ -O2 -std=c++17 benchmark.cpp -o benchmark
+//     ./benchmark [--max-size=N] [--repetitions=R]
+//
+// Для каждой операции, типа элемента и размера от 1e2 до max-size (по умолчанию 1e6,
+// максимум 1e8) печатается лучшее из R измерений для обоих контейнеров и их отношение.
+// Insert/Erase выполняют min(size, 1000) вставок или удалений в вектор размера size.
+// В конце печатается перерасход памяти каждой политики роста из growth_policy.h
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Не даёт компилятору выбросить вычисление value
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Перемещаемый, но не копируемый объект, как NoCopyObj в main.cpp
+class MoveOnlyObj {
+public:
+    MoveOnlyObj(size_t num = 5)
+            : x_(num) {
+    }
+    MoveOnlyObj(const MoveOnlyObj&) = delete;
+    MoveOnlyObj& operator=(const MoveOnlyObj&) = delete;
+    MoveOnlyObj(MoveOnlyObj&& other) noexcept
+            : x_(exchange(other.x_, 0)) {
+    }
+    MoveOnlyObj& operator=(MoveOnlyObj&& other) noexcept {
+        x_ = exchange(other.x_, 0);
+        return *this;
+    }
+    size_t GetX() const {
+        return x_;
+    }
+    bool operator==(const MoveOnlyObj& other) const {
+        return x_ == other.x_;
+    }
+    bool operator<(const MoveOnlyObj& other) const {
+        return x_ < other.x_;
+    }
+
+private:
+    size_t x_;
+};
+
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (is_same_v<T, string>) {
+        // Длина больше буфера малых строк, чтобы строка жила в куче
+        return "benchmark string value #"s + to_string(i);
+    } else {
+        return T(i);
+    }
+}
+
+// Единый интерфейс к std::vector и SimpleVector
+template <typename T>
+void PushBack(vector<T>& v, T value) {
+    v.push_back(move(value));
+}
+
+template <typename T>
+void PushBack(SimpleVector<T>& v, T value) {
+    v.PushBack(move(value));
+}
+
+template <typename T>
+void ReserveFor(vector<T>& v, size_t n) {
+    v.reserve(n);
+}
+
+template <typename T>
+void ReserveFor(SimpleVector<T>& v, size_t n) {
+    v.Reserve(n);
+}
+
+template <typename T>
+void InsertAt(vector<T>& v, size_t pos, T value) {
+    v.insert(v.begin() + pos, move(value));
+}
+
+template <typename T>
+void InsertAt(SimpleVector<T>& v, size_t pos, T value) {
+    v.Insert(v.begin() + pos, move(value));
+}
+
+template <typename T>
+void EraseAt(vector<T>& v, size_t pos) {
+    v.erase(v.begin() + pos);
+}
+
+template <typename T>
+void EraseAt(SimpleVector<T>& v, size_t pos) {
+    v.Erase(v.begin() + pos);
+}
+
+template <typename T>
+size_t SizeOf(const vector<T>& v) {
+    return v.size();
+}
+
+template <typename T>
+size_t SizeOf(const SimpleVector<T>& v) {
+    return v.GetSize();
+}
+
+template <typename Container, typename T>
+Container MakeFilled(size_t n) {
+    Container v;
+    ReserveFor(v, n);
+    for (size_t i = 0; i < n; ++i) {
+        PushBack(v, MakeValue<T>(i));
+    }
+    return v;
+}
+
+struct Options {
+    size_t max_size = 1'000'000;
+    int repetitions = 3;
+};
+
+// Лучшее время из repetitions запусков в наносекундах. setup готовит состояние
+// вне замера и возвращает его, run выполняет измеряемую операцию
+template <typename Setup, typename Run>
+double MeasureNs(int repetitions, Setup setup, Run run) {
+    double best = 0;
+    for (int i = 0; i < repetitions; ++i) {
+        auto state = setup();
+        const auto start = chrono::steady_clock::now();
+        run(state);
+        const auto finish = chrono::steady_clock::now();
+        DoNotOptimize(state);
+        const double ns = chrono::duration<double, nano>(finish - start).count();
+        best = i == 0 ? ns : min(best, ns);
+    }
+    return best;
+}
+
+void PrintHeader() {
+    cout << left << setw(28) << "operation" << setw(14) << "type" << right << setw(12) << "size"
+         << setw(16) << "SimpleVector,ms" << setw(16) << "std::vector,ms" << setw(10) << "ratio" << '\n';
+}
+
+void PrintRow(string_view operation, string_view type, size_t size, double simple_ns, double std_ns) {
+    cout << left << setw(28) << operation << setw(14) << type << right << setw(12) << size << fixed
+         << setprecision(3) << setw(16) << simple_ns / 1e6 << setw(16) << std_ns / 1e6 << setw(10)
+         << (std_ns > 0 ? simple_ns / std_ns : 0.0) << '\n';
+}
+
+// Выполняет один и тот же сценарий для обоих контейнеров и печатает строку результата
+template <typename T, typename Scenario>
+void Compare(const Options& options, string_view operation, string_view type, size_t size, Scenario scenario) {
+    const double simple_ns = scenario(options, size, static_cast<SimpleVector<T>*>(nullptr));
+    const double std_ns = scenario(options, size, static_cast<vector<T>*>(nullptr));
+    PrintRow(operation, type, size, simple_ns, std_ns);
+}
+
+template <typename T>
+void RunSuite(const Options& options, string_view type) {
+    for (size_t size = 100; size <= options.max_size; size *= 10) {
+        Compare<T>(options, "PushBack", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [] { return Container(); }, [n](Container& v) {
+                for (size_t i = 0; i < n; ++i) {
+                    PushBack(v, MakeValue<T>(i));
+                }
+            });
+        });
+        Compare<T>(options, "PushBack after Reserve", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [] { return Container(); }, [n](Container& v) {
+                ReserveFor(v, n);
+                for (size_t i = 0; i < n; ++i) {
+                    PushBack(v, MakeValue<T>(i));
+                }
+            });
+        });
+
+        // Вставки и удаления в середине и начале квадратичны, поэтому их
+        // число ограничено, а размер вектора остаётся равным size
+        const size_t edits = min<size_t>(size, 1000);
+        for (const auto& [where, name] : {pair{0, "front"sv}, pair{1, "middle"sv}, pair{2, "back"sv}}) {
+            const string insert_name = "Insert at "s + string(name);
+            Compare<T>(options, insert_name, type, size, [edits, where = where](const Options& o, size_t n, auto* tag) {
+                using Container = remove_pointer_t<decltype(tag)>;
+                return MeasureNs(o.repetitions, [n] { return MakeFilled<Container, T>(n); }, [&](Container& v) {
+                    for (size_t i = 0; i < edits; ++i) {
+                        const size_t pos = where == 0 ? 0 : where == 1 ? SizeOf(v) / 2 : SizeOf(v);
+                        InsertAt(v, pos, MakeValue<T>(i));
+                    }
+                });
+            });
+            const string erase_name = "Erase at "s + string(name);
+            Compare<T>(options, erase_name, type, size, [edits, where = where](const Options& o, size_t n, auto* tag) {
+                using Container = remove_pointer_t<decltype(tag)>;
+                return MeasureNs(o.repetitions, [n] { return MakeFilled<Container, T>(n); }, [&](Container& v) {
+                    for (size_t i = 0; i < edits && SizeOf(v) > 0; ++i) {
+                        const size_t pos = where == 0 ? 0 : where == 1 ? SizeOf(v) / 2 : SizeOf(v) - 1;
+                        EraseAt(v, pos);
+                    }
+                });
+            });
+        }
+
+        if constexpr (is_copy_constructible_v<T>) {
+            Compare<T>(options, "Copy construction", type, size, [](const Options& o, size_t n, auto* tag) {
+                using Container = remove_pointer_t<decltype(tag)>;
+                return MeasureNs(o.repetitions, [n] { return pair{MakeFilled<Container, T>(n), Container()}; },
+                                 [](auto& state) {
+                                     Container copy(state.first);
+                                     state.second = move(copy);
+                                 });
+            });
+        }
+        Compare<T>(options, "Move construction", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [n] { return pair{MakeFilled<Container, T>(n), Container()}; },
+                             [](auto& state) {
+                                 Container moved(move(state.first));
+                                 state.second = move(moved);
+                             });
+        });
+
+        Compare<T>(options, "operator==", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [n] { return pair{MakeFilled<Container, T>(n), MakeFilled<Container, T>(n)}; },
+                             [](auto& state) {
+                                 DoNotOptimize(state.first == state.second);
+                             });
+        });
+        Compare<T>(options, "operator<", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [n] { return pair{MakeFilled<Container, T>(n), MakeFilled<Container, T>(n)}; },
+                             [](auto& state) {
+                                 DoNotOptimize(state.first < state.second);
+                             });
+        });
+
+        Compare<T>(options, "Iteration", type, size, [](const Options& o, size_t n, auto* tag) {
+            using Container = remove_pointer_t<decltype(tag)>;
+            return MeasureNs(o.repetitions, [n] { return MakeFilled<Container, T>(n); }, [](Container& v) {
+                size_t sum = 0;
+                for (const T& value : v) {
+                    if constexpr (is_same_v<T, string>) {
+                        sum += value.size();
+                    } else if constexpr (is_same_v<T, MoveOnlyObj>) {
+                        sum += value.GetX();
+                    } else {
+                        sum += static_cast<size_t>(value);
+                    }
+                }
+                DoNotOptimize(sum);
+            });
+        });
+    }
+}
+
+// Добавляет size элементов по одному и сообщает, сколько раз перевыделялась память
+// и какая доля вместимости осталась неиспользованной
+template <typename GrowthPolicy>
+void ReportGrowthOverhead(string_view name, size_t size) {
+    SimpleVector<int, allocator<int>, GrowthPolicy> v;
+    size_t reallocations = 0;
+    for (size_t i = 0; i < size; ++i) {
+        const size_t capacity = v.GetCapacity();
+        v.PushBack(static_cast<int>(i));
+        reallocations += capacity != v.GetCapacity();
+    }
+    const double overhead = 100.0 * static_cast<double>(v.GetCapacity() - size) / static_cast<double>(size);
+    cout << left << setw(20) << name << right << setw(12) << size << setw(14) << v.GetCapacity() << setw(16)
+         << reallocations << setw(14) << fixed << setprecision(1) << overhead << '\n';
+}
+
+void RunGrowthReport(const Options& options) {
+    cout << "\nGrowth policy memory overhead\n";
+    cout << left << setw(20) << "policy" << right << setw(12) << "size" << setw(14) << "capacity" << setw(16)
+         << "reallocations" << setw(14) << "overhead,%" << '\n';
+    for (size_t size = 100; size <= options.max_size; size *= 10) {
+        // Размер чуть больше степени двойки — худший случай для удвоения
+        const size_t awkward = size + size / 4;
+        for (size_t n : {size, awkward}) {
+            ReportGrowthOverhead<DoublingGrowth>("Doubling", n);
+            ReportGrowthOverhead<OneAndHalfGrowth>("OneAndHalf", n);
+            ReportGrowthOverhead<GoldenRatioGrowth>("GoldenRatio", n);
+            ReportGrowthOverhead<SizeClassGrowth<>>("SizeClass", n);
+        }
+    }
+}
+
+Options ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg.substr(0, 11) == "--max-size=") {
+            options.max_size = min<size_t>(strtoull(argv[i] + 11, nullptr, 10), 100'000'000);
+        } else if (arg.substr(0, 14) == "--repetitions=") {
+            options.repetitions = max(1, atoi(argv[i] + 14));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--max-size=N] [--repetitions=R]" << endl;
+            exit(1);
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const Options options = ParseOptions(argc, argv);
+    PrintHeader();
+    RunSuite<int>(options, "int");
+    RunSuite<string>(options, "string");
+    RunSuite<MoveOnlyObj>(options, "MoveOnlyObj");
+    RunGrowthReport(options);
+    return 0;
+}
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "simd_kernels.h"
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "vector_checks.h"
+
+// Массив флагов, упакованных по 64 в слово. SimpleVector<bool> тратит на флаг байт,
+// а BitVector — бит, поэтому большие битовые индексы занимают в восемь раз меньше
+// памяти, а операции над ними обрабатывают по 64 флага за раз:
+//
+//     BitVector matches(rows, false);
+//     matches[17] = true;
+//     matches &= visible;               // побитовое И двух индексов
+//     for (size_t row = matches.FindFirstSet(); row < matches.GetSize();
+//          row = matches.FindNextSet(row + 1)) { ... }
+//
+// operator[] возвращает прокси-объект Reference, а не bool&: адресовать отдельный бит
+// нельзя. Resize и Fill заполняют память словами, Count считает единицы аппаратным
+// popcnt, а &=, |= и ^= используют ядра simd_kernels.h. Биты последнего слова за
+// пределами размера всегда нулевые, поэтому ядрам не нужно отдельно обрабатывать хвост
+class BitVector {
+public:
+
+    static constexpr size_t kWordBits = 64;
+
+    // Ссылка на бит вектора. Как и ссылка на элемент, становится недействительной
+    // после перевыделения буфера слов
+    class Reference {
+    public:
+
+        Reference(const Reference&) = default;
+
+        Reference& operator=(bool value) noexcept {
+            *word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+            return *this;
+        }
+
+        // Присваивает значение бита, а не перенаправляет ссылку, как bool&
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        operator bool() const noexcept {
+            return (*word_ & mask_) != 0;
+        }
+
+        void Flip() noexcept {
+            *word_ ^= mask_;
+        }
+
+    private:
+
+        friend class BitVector;
+
+        Reference(uint64_t* word, uint64_t mask) noexcept : word_(word), mask_(mask) {
+        }
+
+        uint64_t* word_;
+        uint64_t mask_;
+    };
+
+    BitVector() = default;
+
+    // Создаёт вектор из size флагов со значением value
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+    BitVector(std::initializer_list<bool> init) {
+        Reserve(init.size());
+        for (bool value : init) {
+            PushBack(value);
+        }
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает число флагов, которые поместятся без перевыделения
+    size_t GetCapacity() const noexcept {
+        return words_.GetCapacity() * kWordBits;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает слова вектора: флаг i — бит i % 64 слова i / 64
+    SimpleSpan<const uint64_t> GetWords() const noexcept {
+        return {words_.Data(), words_.GetSize()};
+    }
+
+    Reference operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return {words_.Data() + index / kWordBits, BitMask(index)};
+    }
+
+    bool operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return (words_.Data()[index / kWordBits] & BitMask(index)) != 0;
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    bool At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return (*this)[index];
+    }
+
+    void Clear() noexcept {
+        words_.Clear();
+        size_ = 0;
+    }
+
+    // Резервирует память под capacity флагов. Память не заполняется: слова
+    // обнуляются, только когда в них появляются флаги
+    void Reserve(size_t capacity) {
+        words_.Reserve(WordCount(capacity));
+    }
+
+    void ShrinkToFit() {
+        words_.ShrinkToFit();
+    }
+
+    // Изменяет размер. Новые флаги получают значение value и заполняются словами
+    void Resize(size_t new_size, bool value = false) {
+        const size_t old_size = size_;
+        words_.Resize(WordCount(new_size));
+        size_ = new_size;
+        if (new_size > old_size && value) {
+            Fill(old_size, new_size, true);
+        }
+        ClearTail();
+    }
+
+    void PushBack(bool value) {
+        if (size_ % kWordBits == 0) {
+            words_.PushBack(0);
+        }
+        if (value) {
+            words_[size_ / kWordBits] |= BitMask(size_);
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            --size_;
+            if (size_ % kWordBits == 0) {
+                words_.PopBack();
+            } else {
+                words_[size_ / kWordBits] &= ~BitMask(size_);
+            }
+        }
+    }
+
+    // Присваивает value всем флагам
+    void Fill(bool value) noexcept {
+        std::fill_n(words_.Data(), words_.GetSize(), value ? ~uint64_t(0) : uint64_t(0));
+        ClearTail();
+    }
+
+    // Присваивает value флагам [first, last): крайние слова меняются по маске,
+    // а промежуточные заполняются целиком
+    void Fill(size_t first, size_t last, bool value) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(first <= last && last <= size_, "range out of bounds");
+        if (first == last) {
+            return;
+        }
+        uint64_t* words = words_.Data();
+        const size_t first_word = first / kWordBits;
+        const size_t last_word = (last - 1) / kWordBits;
+        const uint64_t first_mask = ~uint64_t(0) << (first % kWordBits);
+        const uint64_t last_mask = ~uint64_t(0) >> (kWordBits - 1 - (last - 1) % kWordBits);
+        if (first_word == last_word) {
+            ApplyMask(words[first_word], first_mask & last_mask, value);
+            return;
+        }
+        ApplyMask(words[first_word], first_mask, value);
+        std::fill(words + first_word + 1, words + last_word, value ? ~uint64_t(0) : uint64_t(0));
+        ApplyMask(words[last_word], last_mask, value);
+    }
+
+    // Инвертирует все флаги
+    void Flip() noexcept {
+        uint64_t* words = words_.Data();
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            words[i] = ~words[i];
+        }
+        ClearTail();
+    }
+
+    // Возвращает число установленных флагов
+    size_t Count() const noexcept {
+        return simd::PopCountWords(words_.Data(), words_.GetSize());
+    }
+
+    bool Any() const noexcept {
+        return simd::FindNonZeroWord(words_.Data(), words_.GetSize()) != words_.GetSize();
+    }
+
+    bool None() const noexcept {
+        return !Any();
+    }
+
+    // Возвращает индекс первого установленного флага или GetSize(), если таких нет
+    size_t FindFirstSet() const noexcept {
+        return FindSetFromWord(0);
+    }
+
+    // Возвращает индекс первого установленного флага, не меньший from, или GetSize()
+    size_t FindNextSet(size_t from) const noexcept {
+        if (from >= size_) {
+            return size_;
+        }
+        const size_t word = from / kWordBits;
+        const uint64_t bits = words_.Data()[word] & (~uint64_t(0) << (from % kWordBits));
+        if (bits != 0) {
+            return word * kWordBits + simd::detail::CountTrailingZeros(bits);
+        }
+        return FindSetFromWord(word + 1);
+    }
+
+    // Вызывает fn(index) для каждого установленного флага по возрастанию индексов.
+    // Нулевые слова пропускаются целиком
+    template <typename Fn>
+    void ForEachSet(Fn fn) const {
+        const uint64_t* words = words_.Data();
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            for (uint64_t bits = words[i]; bits != 0; bits &= bits - 1) {
+                fn(i * kWordBits + simd::detail::CountTrailingZeros(bits));
+            }
+        }
+    }
+
+    // Побитовые операции с вектором того же размера
+    BitVector& operator&=(const BitVector& other) noexcept(!kVectorChecked) {
+        return Combine<simd::detail::WordOp::kAnd>(other);
+    }
+
+    BitVector& operator|=(const BitVector& other) noexcept(!kVectorChecked) {
+        return Combine<simd::detail::WordOp::kOr>(other);
+    }
+
+    BitVector& operator^=(const BitVector& other) noexcept(!kVectorChecked) {
+        return Combine<simd::detail::WordOp::kXor>(other);
+    }
+
+    // Сбрасывает флаги, установленные в other
+    BitVector& AndNot(const BitVector& other) noexcept(!kVectorChecked) {
+        return Combine<simd::detail::WordOp::kAndNot>(other);
+    }
+
+    void swap(BitVector& other) noexcept {
+        words_.swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+
+    SimpleVector<uint64_t> words_;
+    size_t size_ = 0;
+
+    static size_t WordCount(size_t size) noexcept {
+        return (size + kWordBits - 1) / kWordBits;
+    }
+
+    static uint64_t BitMask(size_t index) noexcept {
+        return uint64_t(1) << (index % kWordBits);
+    }
+
+    static void ApplyMask(uint64_t& word, uint64_t mask, bool value) noexcept {
+        word = value ? word | mask : word & ~mask;
+    }
+
+    // Обнуляет биты последнего слова за пределами размера
+    void ClearTail() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[size_ / kWordBits] &= ~(~uint64_t(0) << (size_ % kWordBits));
+        }
+    }
+
+    size_t FindSetFromWord(size_t word) const noexcept {
+        const size_t words = words_.GetSize();
+        if (word >= words) {
+            return size_;
+        }
+        const size_t found = word + simd::FindNonZeroWord(words_.Data() + word, words - word);
+        if (found == words) {
+            return size_;
+        }
+        return found * kWordBits + simd::detail::CountTrailingZeros(words_.Data()[found]);
+    }
+
+    // При разных размерах операция затрагивает только общие слова
+    template <simd::detail::WordOp Op>
+    BitVector& Combine(const BitVector& other) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(size_ == other.size_, "bit vectors have different sizes");
+        simd::CombineWords<Op>(words_.Data(), other.words_.Data(), std::min(words_.GetSize(), other.words_.GetSize()));
+        ClearTail();
+        return *this;
+    }
+
+};
+
+// Хвостовые биты обоих векторов нулевые, поэтому достаточно сравнить слова
+inline bool operator==(const BitVector& lhs, const BitVector& rhs) {
+    return lhs.GetSize() == rhs.GetSize() && lhs.GetWords() == rhs.GetWords();
+}
+
+inline bool operator!=(const BitVector& lhs, const BitVector& rhs) {
+    return !(lhs == rhs);
+}
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs) {
+    lhs &= rhs;
+    return lhs;
+}
+
+inline BitVector operator|(BitVector lhs, const BitVector& rhs) {
+    lhs |= rhs;
+    return lhs;
+}
+
+inline BitVector operator^(BitVector lhs, const BitVector& rhs) {
+    lhs ^= rhs;
+    return lhs;
+}
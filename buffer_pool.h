@@ -0,0 +1,293 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#include "growth_policy.h"
+#include "simple_vector.h"
+
+// Пул недавно освобождённых буферов, свой у каждого потока. Короткоживущие векторы
+// похожей вместимости получают память из пула текущего потока без обращения к куче
+// и без захвата её блокировок, поэтому потоки не соперничают за malloc:
+//
+//     PooledSimpleVector<Item> batch;  // память берётся из пула и возвращается в него
+//
+// Буферы до kPoolMaxBlockBytes байт округляются вверх до степени двойки, и для каждого
+// такого класса пул хранит список свободных буферов. Буферы крупнее выделяются в куче
+// напрямую. Буфер, освобождённый в другом потоке, попадает в пул этого потока.
+// Число и объём хранимых буферов ограничены BufferPoolLimits, лишние возвращаются в кучу
+
+// Наибольший размер буфера, который проходит через пул. Задаётся макросом до подключения
+// заголовков, например -DSIMPLE_VECTOR_POOL_MAX_BLOCK_BYTES=4194304
+#ifndef SIMPLE_VECTOR_POOL_MAX_BLOCK_BYTES
+#define SIMPLE_VECTOR_POOL_MAX_BLOCK_BYTES (size_t(1) << 20)
+#endif
+
+inline constexpr size_t kPoolMaxBlockBytes = SIMPLE_VECTOR_POOL_MAX_BLOCK_BYTES;
+static_assert((kPoolMaxBlockBytes & (kPoolMaxBlockBytes - 1)) == 0, "Pool block size must be a power of two");
+
+// Ограничения на свободные буферы, которые хранит пул одного потока
+struct BufferPoolLimits {
+    // Наибольшее число свободных буферов одного класса
+    size_t max_blocks_per_class = 32;
+    // Наибольший суммарный объём свободных буферов
+    size_t max_cached_bytes = size_t(8) << 20;
+};
+
+// Счётчики пула одного потока
+struct BufferPoolStats {
+    // Число выделений, обслуженных свободным буфером из пула
+    uint64_t hits = 0;
+    // Число выделений, ушедших в кучу
+    uint64_t misses = 0;
+    // Число буферов, возвращённых в пул
+    uint64_t recycled = 0;
+    // Число буферов, освобождённых в кучу из-за ограничений пула
+    uint64_t released = 0;
+    // Число и объём свободных буферов в пуле сейчас
+    size_t cached_blocks = 0;
+    size_t cached_bytes = 0;
+};
+
+class BufferPool {
+public:
+    // Наименьший класс: в свободном буфере хранится указатель на следующий
+    static constexpr size_t kMinBlockBytes = 16;
+
+    BufferPool() = default;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    ~BufferPool() {
+        Trim();
+    }
+
+    // Возвращает пул текущего потока или nullptr, если поток завершается и пул уже разрушен
+    static BufferPool* Local() noexcept;
+
+    // Сообщает, проходит ли буфер из bytes байт через пул
+    static constexpr bool IsPooled(size_t bytes) noexcept {
+        return bytes <= kPoolMaxBlockBytes;
+    }
+
+    // Возвращает размер буфера, который будет выделен под bytes байт
+    static constexpr size_t BlockSize(size_t bytes) noexcept {
+        if (!IsPooled(bytes)) {
+            return bytes;
+        }
+        if (bytes <= kMinBlockBytes) {
+            return kMinBlockBytes;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        return size_t(1) << (std::numeric_limits<unsigned long long>::digits - __builtin_clzll(bytes - 1));
+#else
+        size_t size = kMinBlockBytes;
+        while (size < bytes) {
+            size <<= 1;
+        }
+        return size;
+#endif
+    }
+
+    // Выделяет буфер не меньше bytes байт, выровненный для любого стандартного типа
+    void* Allocate(size_t bytes) {
+        if (!IsPooled(bytes)) {
+            return ::operator new(bytes);
+        }
+        FreeList& list = classes_[ClassIndex(bytes)];
+        if (list.head == nullptr) {
+            ++stats_.misses;
+            return ::operator new(BlockSize(bytes));
+        }
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        --list.count;
+        --stats_.cached_blocks;
+        stats_.cached_bytes -= BlockSize(bytes);
+        ++stats_.hits;
+        return block;
+    }
+
+    // Возвращает буфер, выделенный под bytes байт (в любом потоке), в пул или в кучу
+    void Deallocate(void* buffer, size_t bytes) noexcept {
+        if (!IsPooled(bytes)) {
+            ::operator delete(buffer);
+            return;
+        }
+        const size_t size = BlockSize(bytes);
+        FreeList& list = classes_[ClassIndex(bytes)];
+        if (list.count >= limits_.max_blocks_per_class || stats_.cached_bytes + size > limits_.max_cached_bytes) {
+            ++stats_.released;
+            ::operator delete(buffer);
+            return;
+        }
+        list.head = ::new (buffer) FreeBlock{list.head};
+        ++list.count;
+        ++stats_.cached_blocks;
+        stats_.cached_bytes += size;
+        ++stats_.recycled;
+    }
+
+    // Выделяет буфер в пуле текущего потока, а если пул уже разрушен, — в куче
+    static void* AllocateLocal(size_t bytes) {
+        BufferPool* pool = Local();
+        return pool != nullptr ? pool->Allocate(bytes) : ::operator new(BlockSize(bytes));
+    }
+
+    static void DeallocateLocal(void* buffer, size_t bytes) noexcept {
+        if (BufferPool* pool = Local()) {
+            pool->Deallocate(buffer, bytes);
+        } else {
+            ::operator delete(buffer);
+        }
+    }
+
+    // Задаёт ограничения и сразу освобождает буферы, которые в них не помещаются
+    void SetLimits(const BufferPoolLimits& limits) noexcept {
+        limits_ = limits;
+        for (size_t index = kClassCount; index-- > 0;) {
+            FreeList& list = classes_[index];
+            while (list.head != nullptr
+                   && (list.count > limits_.max_blocks_per_class || stats_.cached_bytes > limits_.max_cached_bytes)) {
+                ReleaseHead(list, size_t(1) << index);
+            }
+        }
+    }
+
+    const BufferPoolLimits& GetLimits() const noexcept {
+        return limits_;
+    }
+
+    const BufferPoolStats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    // Обнуляет счётчики событий, не трогая сведения о свободных буферах
+    void ResetStats() noexcept {
+        stats_.hits = stats_.misses = stats_.recycled = stats_.released = 0;
+    }
+
+    // Освобождает все свободные буферы в кучу
+    void Trim() noexcept {
+        for (size_t index = 0; index < kClassCount; ++index) {
+            while (classes_[index].head != nullptr) {
+                ReleaseHead(classes_[index], size_t(1) << index);
+            }
+        }
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct FreeList {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+    };
+
+    static constexpr size_t kClassCount = std::numeric_limits<size_t>::digits;
+
+    // Список класса с размером буфера 2^index
+    FreeList classes_[kClassCount] = {};
+    BufferPoolLimits limits_ = {};
+    BufferPoolStats stats_ = {};
+
+    static size_t ClassIndex(size_t bytes) noexcept {
+        const size_t size = BlockSize(bytes);
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_ctzll(size));
+#else
+        size_t index = 0;
+        while ((size_t(1) << index) != size) {
+            ++index;
+        }
+        return index;
+#endif
+    }
+
+    void ReleaseHead(FreeList& list, size_t size) noexcept {
+        FreeBlock* block = list.head;
+        list.head = block->next;
+        --list.count;
+        --stats_.cached_blocks;
+        stats_.cached_bytes -= size;
+        ++stats_.released;
+        ::operator delete(block);
+    }
+};
+
+// Признак того, что пул потока уже разрушен. Тривиально разрушаемая thread_local переменная
+// доступна до самого конца потока, в том числе из деструкторов других thread_local объектов
+inline bool& BufferPoolDestroyed() noexcept {
+    thread_local bool destroyed = false;
+    return destroyed;
+}
+
+inline BufferPool* BufferPool::Local() noexcept {
+    struct LocalPool : BufferPool {
+        ~LocalPool() {
+            BufferPoolDestroyed() = true;
+        }
+    };
+    if (BufferPoolDestroyed()) {
+        return nullptr;
+    }
+    thread_local LocalPool pool;
+    return &pool;
+}
+
+// Аллокатор, получающий память из пула текущего потока. Все экземпляры равны:
+// буфер можно освободить в любом потоке. Типы с выравниванием больше стандартного
+// выделяются в куче напрямую
+template <typename Type>
+struct PooledAllocator {
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+
+    PooledAllocator() noexcept = default;
+
+    template <typename Other>
+    PooledAllocator(const PooledAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        if constexpr (kOverAligned) {
+            return static_cast<Type*>(::operator new(n * sizeof(Type), std::align_val_t(alignof(Type))));
+        } else {
+            return static_cast<Type*>(BufferPool::AllocateLocal(n * sizeof(Type)));
+        }
+    }
+
+    void deallocate(Type* buffer, size_t n) noexcept {
+        if constexpr (kOverAligned) {
+            ::operator delete(buffer, std::align_val_t(alignof(Type)));
+        } else {
+            BufferPool::DeallocateLocal(buffer, n * sizeof(Type));
+        }
+    }
+
+    template <typename Other>
+    bool operator==(const PooledAllocator<Other>&) const noexcept {
+        return true;
+    }
+
+    template <typename Other>
+    bool operator!=(const PooledAllocator<Other>&) const noexcept {
+        return false;
+    }
+
+private:
+    static constexpr bool kOverAligned = alignof(Type) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+};
+
+// SimpleVector, чьи буферы проходят через пул текущего потока
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+using PooledSimpleVector = SimpleVector<Type, PooledAllocator<Type>, GrowthPolicy>;
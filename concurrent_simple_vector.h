@@ -0,0 +1,256 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "segmented_vector.h"
+#include "simd_kernels.h"
+#include "simple_vector.h"
+#include "vector_stats.h"
+
+// Вектор, в который несколько потоков одновременно добавляют элементы без блокировок.
+// Индекс нового элемента резервируется атомарным fetch_add, а сами элементы хранятся
+// в сегментах удваивающегося размера, как у SegmentedVector (см. SegmentLayout).
+// Уже созданные сегменты никогда не перемещаются, поэтому ссылки на добавленные элементы
+// остаются действительными при росте. Рядом с каждым сегментом хранятся биты
+// сконструированных ячеек: ячейка, в которой конструктор или выделение сегмента
+// бросили исключение, остаётся зарезервированной, но Freeze и деструктор её пропускают.
+//
+// Одновременно с PushBack/EmplaceBack можно вызывать GetSize, Reserve и обращаться
+// к элементам по ссылкам, которые вернули PushBack/EmplaceBack. Остальные функции
+// (operator[] для чужих элементов, Freeze, деструктор) требуют, чтобы добавление
+// завершилось и было синхронизировано с читающим потоком, например через join.
+// Аллокатор вызывается из нескольких потоков и должен это допускать
+template <typename Type, typename Allocator = std::allocator<Type>>
+class ConcurrentSimpleVector {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+public:
+
+    using allocator_type = Allocator;
+
+    // Размер первого сегмента, степень двойки
+    static constexpr size_t kFirstSegmentSize = SegmentLayout::kFirstSegmentSize;
+
+    ConcurrentSimpleVector() = default;
+
+    explicit ConcurrentSimpleVector(const Allocator& allocator) noexcept
+            : allocator_(allocator) {
+    }
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ~ConcurrentSimpleVector() {
+        DestroyAll();
+    }
+
+    // Добавляет элемент и возвращает ссылку на него. Выполняется за ограниченное число шагов
+    // независимо от других потоков; если нужный сегмент ещё не выделен, его выделяют все
+    // претендующие потоки, и лишние копии сразу освобождаются
+    Type& PushBack(const Type& item) {
+        return EmplaceBack(item);
+    }
+
+    Type& PushBack(Type&& item) {
+        return EmplaceBack(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            Type* place = Slot(index, true);
+            AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+            MarkConstructed(index);
+            return *place;
+        } catch (...) {
+            // Ячейка уже зарезервирована и не может быть возвращена. Её бит не установлен,
+            // поэтому несконструированный объект не будет ни разрушен, ни перенесён
+            failures_.fetch_add(1, std::memory_order_relaxed);
+            throw;
+        }
+    }
+
+    // Заранее выделяет сегменты под capacity элементов, чтобы PushBack не выделял память
+    void Reserve(size_t capacity) {
+        for (size_t segment = 0; SegmentStart(segment) < capacity; ++segment) {
+            AcquireSegment(segment);
+        }
+    }
+
+    // Возвращает число добавленных элементов, включая те, что ещё конструируются
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index < GetSize()
+    Type& operator[](size_t index) noexcept {
+        return *Slot(index, false);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return *const_cast<ConcurrentSimpleVector*>(this)->Slot(index, false);
+    }
+
+    // Переносит элементы в непрерывный SimpleVector и оставляет *this пустым.
+    // Элементы, чей конструктор бросил исключение, пропускаются
+    SimpleVector<Type, Allocator> Freeze() {
+        SimpleVector<Type, Allocator> result(allocator_);
+        const size_t size = GetSize();
+        const bool complete = failures_.load(std::memory_order_relaxed) == 0;
+        result.Reserve(size - failures_.load(std::memory_order_relaxed));
+        ForEachSegment(size, [&](Type* first, size_t count, size_t segment) {
+            if (complete) {
+                result.Append(std::make_move_iterator(first), std::make_move_iterator(first + count));
+                return;
+            }
+            ForEachConstructed(segment, count, [&](size_t offset) {
+                result.EmplaceBack(std::move(first[offset]));
+            });
+        });
+        DestroyAll();
+        return result;
+    }
+
+private:
+
+    static constexpr size_t kSegmentCount = SegmentLayout::kSegmentCount;
+    static constexpr size_t kFlagBits = 64;
+
+    using Flags = std::atomic<uint64_t>;
+    using FlagAllocator = typename AllocatorTraits::template rebind_alloc<Flags>;
+    using FlagTraits = std::allocator_traits<FlagAllocator>;
+
+    [[no_unique_address]] Allocator allocator_ = {};
+    std::atomic<size_t> size_{0};
+    std::atomic<Type*> segments_[kSegmentCount] = {};
+    // Биты сконструированных ячеек каждого сегмента. Выделяются раньше сегмента,
+    // поэтому у опубликованного сегмента они всегда есть
+    std::atomic<Flags*> constructed_[kSegmentCount] = {};
+    // Число ячеек, в которых добавление бросило исключение
+    std::atomic<size_t> failures_{0};
+
+    static size_t SegmentStart(size_t segment) noexcept {
+        return SegmentLayout::SegmentStart(segment);
+    }
+
+    static size_t SegmentSize(size_t segment) noexcept {
+        return SegmentLayout::SegmentSize(segment);
+    }
+
+    static size_t FlagWords(size_t segment) noexcept {
+        return (SegmentSize(segment) + kFlagBits - 1) / kFlagBits;
+    }
+
+    // Вычисляет адрес ячейки index, при allocate выделяя её сегмент
+    Type* Slot(size_t index, bool allocate) {
+        const SegmentLayout::Position position = SegmentLayout::Locate(index);
+        Type* base = allocate ? AcquireSegment(position.segment)
+                              : segments_[position.segment].load(std::memory_order_relaxed);
+        return base + position.offset;
+    }
+
+    // Возвращает сегмент, выделяя его, если он ещё не выделен. Из нескольких потоков,
+    // выделивших сегмент, его публикует первый, остальные освобождают свои копии
+    Type* AcquireSegment(size_t segment) {
+        Type* current = segments_[segment].load(std::memory_order_acquire);
+        if (current != nullptr) {
+            return current;
+        }
+        AcquireFlags(segment);
+        Type* allocated = AllocatorTraits::allocate(allocator_, SegmentSize(segment));
+        if (segments_[segment].compare_exchange_strong(current, allocated, std::memory_order_acq_rel)) {
+            RecordAllocation<Type>(SegmentSize(segment) * sizeof(Type));
+            return allocated;
+        }
+        AllocatorTraits::deallocate(allocator_, allocated, SegmentSize(segment));
+        return current;
+    }
+
+    // Выделяет обнулённые биты сегмента так же, как AcquireSegment выделяет сам сегмент
+    void AcquireFlags(size_t segment) {
+        if (constructed_[segment].load(std::memory_order_acquire) != nullptr) {
+            return;
+        }
+        FlagAllocator allocator(allocator_);
+        Flags* allocated = FlagTraits::allocate(allocator, FlagWords(segment));
+        for (size_t i = 0; i < FlagWords(segment); ++i) {
+            FlagTraits::construct(allocator, allocated + i, uint64_t(0));
+        }
+        Flags* current = nullptr;
+        if (!constructed_[segment].compare_exchange_strong(current, allocated, std::memory_order_acq_rel)) {
+            FlagTraits::deallocate(allocator, allocated, FlagWords(segment));
+        }
+    }
+
+    // Отмечает ячейку index сконструированной. Биты читаются только после синхронизации
+    // с добавляющими потоками, поэтому упорядочивание не требуется
+    void MarkConstructed(size_t index) noexcept {
+        const SegmentLayout::Position position = SegmentLayout::Locate(index);
+        Flags* flags = constructed_[position.segment].load(std::memory_order_relaxed);
+        flags[position.offset / kFlagBits].fetch_or(uint64_t(1) << (position.offset % kFlagBits),
+                                                    std::memory_order_relaxed);
+    }
+
+    // Вызывает fn(offset) для сконструированных ячеек среди первых count ячеек сегмента
+    template <typename Fn>
+    void ForEachConstructed(size_t segment, size_t count, Fn fn) {
+        const Flags* flags = constructed_[segment].load(std::memory_order_relaxed);
+        for (size_t word = 0; word * kFlagBits < count; ++word) {
+            for (uint64_t bits = flags[word].load(std::memory_order_relaxed); bits != 0; bits &= bits - 1) {
+                fn(word * kFlagBits + simd::detail::CountTrailingZeros(bits));
+            }
+        }
+    }
+
+    // Вызывает fn(first, count, segment) для заполненной части каждого сегмента.
+    // Сегмент может остаться невыделенным, только если выделение провалилось
+    // у всех потоков, получивших в нём индексы, и тогда в нём нет элементов
+    template <typename Fn>
+    void ForEachSegment(size_t size, Fn fn) {
+        for (size_t segment = 0; SegmentStart(segment) < size; ++segment) {
+            const size_t start = SegmentStart(segment);
+            if (Type* first = segments_[segment].load(std::memory_order_relaxed)) {
+                fn(first, std::min(SegmentSize(segment), size - start), segment);
+            }
+        }
+    }
+
+    // Разрушает все элементы и освобождает сегменты
+    void DestroyAll() noexcept {
+        const bool complete = failures_.load(std::memory_order_relaxed) == 0;
+        ForEachSegment(GetSize(), [&](Type* first, size_t count, size_t segment) {
+            if (complete) {
+                for (size_t i = 0; i < count; ++i) {
+                    AllocatorTraits::destroy(allocator_, first + i);
+                }
+                return;
+            }
+            ForEachConstructed(segment, count, [&](size_t offset) {
+                AllocatorTraits::destroy(allocator_, first + offset);
+            });
+        });
+        FlagAllocator flag_allocator(allocator_);
+        for (size_t segment = 0; segment < kSegmentCount; ++segment) {
+            if (Type* base = segments_[segment].exchange(nullptr, std::memory_order_relaxed)) {
+                AllocatorTraits::deallocate(allocator_, base, SegmentSize(segment));
+            }
+            if (Flags* flags = constructed_[segment].exchange(nullptr, std::memory_order_relaxed)) {
+                FlagTraits::deallocate(flag_allocator, flags, FlagWords(segment));
+            }
+        }
+        size_.store(0, std::memory_order_relaxed);
+        failures_.store(0, std::memory_order_relaxed);
+    }
+
+};
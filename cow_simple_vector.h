@@ -0,0 +1,367 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.h"
+#include "simd_kernels.h"
+#include "simple_vector.h"
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок,
+// поэтому копирование выполняется за O(1) независимо от размера. Перед первым
+// изменением копия, чей буфер разделяют другие, отделяется — получает собственную
+// копию элементов. Счётчик ссылок атомарный: копии можно передавать в другие потоки
+// и читать или изменять там, но один объект CowSimpleVector, как и shared_ptr,
+// нельзя изменять из нескольких потоков одновременно.
+//
+// Неконстантные operator[], At и begin()/end() тоже отделяют копию, даже если нужны
+// только для чтения: чтобы читать без отделения, используйте константный объект или Get().
+// Указатели и ссылки, полученные до копирования вектора, нельзя использовать для записи
+// после него: они указывают в общий буфер
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class CowSimpleVector {
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+    using Iterator = decltype(std::declval<Vector&>().begin());
+    using ConstIterator = decltype(std::declval<const Vector&>().begin());
+
+public:
+
+    using allocator_type = Allocator;
+
+    CowSimpleVector() noexcept = default;
+
+    explicit CowSimpleVector(const Allocator& allocator) noexcept
+            : allocator_(allocator) {
+    }
+
+    explicit CowSimpleVector(size_t size, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , block_(MakeBlock(allocator, size, allocator)) {
+    }
+
+    CowSimpleVector(size_t size, const Type& value, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , block_(MakeBlock(allocator, size, value, allocator)) {
+    }
+
+    CowSimpleVector(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , block_(MakeBlock(allocator, init, allocator)) {
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    CowSimpleVector(InputIt first, InputIt last, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , block_(MakeBlock(allocator, first, last, allocator)) {
+    }
+
+    // Забирает элементы vector без копирования
+    explicit CowSimpleVector(Vector&& vector)
+            : allocator_(vector.GetAllocator())
+            , block_(MakeBlock(allocator_, std::move(vector))) {
+    }
+
+    explicit CowSimpleVector(const Vector& vector)
+            : allocator_(vector.GetAllocator())
+            , block_(MakeBlock(allocator_, vector, allocator_)) {
+    }
+
+    // Копия разделяет буфер с other
+    CowSimpleVector(const CowSimpleVector& other) noexcept
+            : allocator_(other.allocator_)
+            , block_(other.block_) {
+        if (block_ != nullptr) {
+            block_->references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowSimpleVector(CowSimpleVector&& other) noexcept
+            : allocator_(other.allocator_)
+            , block_(std::exchange(other.block_, nullptr)) {
+    }
+
+    // Присваивание разделяет буфер other. Аллокатор переходит вместе с буфером
+    CowSimpleVector& operator=(const CowSimpleVector& other) noexcept {
+        CowSimpleVector(other).swap(*this);
+        return *this;
+    }
+
+    CowSimpleVector& operator=(CowSimpleVector&& other) noexcept {
+        CowSimpleVector(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~CowSimpleVector() {
+        Release();
+    }
+
+    // Возвращает элементы только для чтения, не отделяя копию
+    const Vector& Get() const noexcept {
+        return block_ != nullptr ? block_->vector : EmptyVector();
+    }
+
+    // Отделяет копию, если буфер разделён, и возвращает элементы для изменения.
+    // Ссылка действительна до следующего копирования *this
+    Vector& Mutable() {
+        if (block_ == nullptr) {
+            block_ = MakeBlock(allocator_, allocator_);
+        } else if (block_->references.load(std::memory_order_acquire) != 1) {
+            Block* copy = MakeBlock(allocator_, block_->vector, allocator_);
+            Release();
+            block_ = copy;
+        }
+        return block_->vector;
+    }
+
+    // Возвращает число векторов, разделяющих буфер (0 для пустого вектора без буфера)
+    size_t UseCount() const noexcept {
+        return block_ != nullptr ? block_->references.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool IsShared() const noexcept {
+        return UseCount() > 1;
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return allocator_;
+    }
+
+    size_t GetSize() const noexcept {
+        return Get().GetSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return Get().GetCapacity();
+    }
+
+    bool IsEmpty() const noexcept {
+        return Get().IsEmpty();
+    }
+
+    Type& operator[](size_t index) {
+        return Mutable()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        return Get()[index];
+    }
+
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return Mutable()[index];
+    }
+
+    const Type& At(size_t index) const {
+        return Get().At(index);
+    }
+
+    ConstIterator Find(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Get().Find(value);
+    }
+
+    bool Contains(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Get().Contains(value);
+    }
+
+    size_t Count(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Get().Count(value);
+    }
+
+    // Отпускает буфер, не копируя элементы, даже если он разделён
+    void Clear() noexcept {
+        Release();
+        block_ = nullptr;
+    }
+
+    void Resize(size_t new_size) {
+        Mutable().Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        Mutable().Reserve(new_capacity);
+    }
+
+    void PushBack(const Type& value) {
+        Mutable().PushBack(value);
+    }
+
+    void PushBack(Type&& value) {
+        Mutable().PushBack(std::move(value));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return Mutable().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    // pos может указывать в общий буфер: он пересчитывается в буфер отделённой копии
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        const size_t offset = pos - cbegin();
+        Vector& vector = Mutable();
+        return vector.Insert(vector.cbegin() + offset, first, last);
+    }
+
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = pos - cbegin();
+        Vector& vector = Mutable();
+        return vector.Emplace(vector.cbegin() + offset, std::forward<Args>(args)...);
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t offset = pos - cbegin();
+        Vector& vector = Mutable();
+        return vector.Erase(vector.cbegin() + offset);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t offset = first - cbegin();
+        const size_t count = last - first;
+        Vector& vector = Mutable();
+        return vector.Erase(vector.cbegin() + offset, vector.cbegin() + offset + count);
+    }
+
+    void PopBack() {
+        if (!IsEmpty()) {
+            Mutable().PopBack();
+        }
+    }
+
+    Iterator begin() {
+        return Mutable().begin();
+    }
+
+    Iterator end() {
+        return Mutable().end();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Get().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return Get().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Get().cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Get().cend();
+    }
+
+    void swap(CowSimpleVector& other) noexcept {
+        using std::swap;
+        swap(allocator_, other.allocator_);
+        swap(block_, other.block_);
+    }
+
+    // Истинно, если векторы разделяют один буфер. Тогда они заведомо равны
+    bool SharesBufferWith(const CowSimpleVector& other) const noexcept {
+        return block_ != nullptr && block_ == other.block_;
+    }
+
+private:
+
+    // Общий буфер: счётчик ссылок и сами элементы
+    struct Block {
+        template <typename... Args>
+        explicit Block(Args&&... args)
+                : vector(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> references{1};
+        Vector vector;
+    };
+
+    using BlockAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Block>;
+    using BlockAllocatorTraits = std::allocator_traits<BlockAllocator>;
+
+    [[no_unique_address]] Allocator allocator_ = {};
+    Block* block_ = nullptr;
+
+    static const Vector& EmptyVector() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    // Создаёт блок в памяти allocator, передавая args конструктору вектора
+    template <typename... Args>
+    static Block* MakeBlock(const Allocator& allocator, Args&&... args) {
+        BlockAllocator block_allocator(allocator);
+        Block* block = BlockAllocatorTraits::allocate(block_allocator, 1);
+        try {
+            BlockAllocatorTraits::construct(block_allocator, block, std::forward<Args>(args)...);
+        } catch (...) {
+            BlockAllocatorTraits::deallocate(block_allocator, block, 1);
+            throw;
+        }
+        return block;
+    }
+
+    // Уменьшает счётчик ссылок и разрушает блок, если ссылок не осталось
+    void Release() noexcept {
+        if (block_ != nullptr && block_->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            BlockAllocator block_allocator(block_->vector.GetAllocator());
+            BlockAllocatorTraits::destroy(block_allocator, block_);
+            BlockAllocatorTraits::deallocate(block_allocator, block_, 1);
+        }
+    }
+
+};
+
+// Общий буфер равен сам себе, только если равенство элементов рефлексивно. Для чисел
+// с плавающей точкой и пользовательских типов это не так (NaN != NaN), поэтому их
+// содержимое сравнивается всегда
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type> || std::is_pointer_v<Type>) {
+        if (lhs.SharesBufferWith(rhs)) {
+            return true;
+        }
+    }
+    return lhs.Get() == rhs.Get();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.Get() < rhs.Get();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs > rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs, const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs > lhs);
+}
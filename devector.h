@@ -0,0 +1,610 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+#include "simd_kernels.h"
+#include "simple_vector.h"
+#include "vector_checks.h"
+#include "vector_stats.h"
+
+// Вектор со свободным местом и перед элементами, и после них (devector). PushFront и PopFront
+// выполняются, как PushBack и PopBack, за амортизированное O(1), а элементы по-прежнему лежат
+// в одном непрерывном буфере: Data() можно передать в SimpleSpan и SIMD-ядра, а очередь
+// из PushBack и PopFront обходится без пересчёта кольцевых индексов на каждом доступе:
+//
+//     Devector<Task> queue;
+//     queue.PushBack(task);
+//     Run(queue[0]);
+//     queue.PopFront();
+//
+// Когда с нужной стороны нет места, элементы сдвигаются к середине буфера, если свободных
+// ячеек больше, чем элементов, а иначе буфер растёт по GrowthPolicy и весь прирост достаётся
+// этой стороне. Сдвиг стоит O(size) и освобождает не меньше size / 2 ячеек, поэтому операции
+// с концами остаются амортизированно O(1). Insert и Erase сдвигают более короткую часть
+// и работают за O(min(offset, size - offset)). SimpleVector этой логикой не нагружается
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class Devector {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    // Сдвиг внутри буфера возможен, только если перенос элемента не бросает исключений:
+    // прерванный сдвиг оставил бы в середине вектора неинициализированные ячейки
+    static constexpr bool kShiftsInPlace = kIsTriviallyRelocatable<Type>
+            || std::is_nothrow_move_constructible_v<Type>;
+
+    // Перемещающее присваивание не выделяет память, если буфер other можно забрать всегда
+    static constexpr bool kNothrowMoveAssign = AllocatorTraits::propagate_on_container_move_assignment::value
+                                               || AllocatorTraits::is_always_equal::value;
+
+public:
+
+    using allocator_type = Allocator;
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    Devector() noexcept = default;
+
+    explicit Devector(const Allocator& allocator) noexcept : data_(allocator) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit Devector(size_t size, const Allocator& allocator = Allocator()) : data_(size, allocator) {
+        data_.ConstructN(data_.Get(), size);
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    Devector(size_t size, const Type& value, const Allocator& allocator = Allocator()) : data_(size, allocator) {
+        data_.ConstructN(data_.Get(), size, value);
+        size_ = size;
+    }
+
+    Devector(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : data_(init.size(), allocator) {
+        data_.CopyConstructN(init.begin(), init.size(), data_.Get());
+        size_ = init.size();
+    }
+
+    // Создаёт вектор из элементов диапазона [first, last)
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    Devector(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : Devector(allocator) {
+        if constexpr (kIsForwardIterator<InputIt>) {
+            Reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    Devector(const Devector& other)
+            : Devector(other, AllocatorTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+    }
+
+    // Копия занимает ровно other.GetSize() ячеек без свободного места по краям
+    Devector(const Devector& other, const Allocator& allocator) : data_(other.size_, allocator) {
+        data_.CopyConstructN(other.Data(), other.size_, data_.Get());
+        size_ = other.size_;
+    }
+
+    Devector(Devector&& other) noexcept
+            : data_(std::move(other.data_))
+            , front_(std::exchange(other.front_, 0))
+            , size_(std::exchange(other.size_, 0)) {
+    }
+
+    // Если аллокаторы не равны, элементы перемещаются по одному в новый буфер
+    Devector(Devector&& other, const Allocator& allocator) : data_(allocator) {
+        if (data_.GetAllocator() == other.data_.GetAllocator()) {
+            data_ = std::move(other.data_);
+            front_ = std::exchange(other.front_, 0);
+            size_ = std::exchange(other.size_, 0);
+        } else {
+            RawMemory<Type, Allocator> new_data(other.size_, allocator);
+            new_data.MoveOrCopyConstructN(other.Data(), other.size_, new_data.Get());
+            data_.swap(new_data);
+            size_ = other.size_;
+            other.Clear();
+        }
+    }
+
+    // Аллокатор other передаётся, только если это разрешает propagate_on_container_copy_assignment
+    Devector& operator=(const Devector& other) {
+        if (this != &other) {
+            if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+                if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                    Clear();
+                    data_.Reset(other.data_.GetAllocator());
+                    front_ = 0;
+                }
+            }
+            Devector copy(other, data_.GetAllocator());
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // Забирает буфер other, если аллокатор передаётся или аллокаторы равны.
+    // Иначе элементы перемещаются по одному в память аллокатора *this
+    Devector& operator=(Devector&& other) noexcept(kNothrowMoveAssign) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (!AllocatorTraits::propagate_on_container_move_assignment::value
+                      && !AllocatorTraits::is_always_equal::value) {
+            if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                Devector temp(std::move(other), data_.GetAllocator());
+                swap(temp);
+                return *this;
+            }
+        }
+        Clear();
+        data_ = std::move(other.data_);
+        front_ = std::exchange(other.front_, 0);
+        size_ = std::exchange(other.size_, 0);
+        return *this;
+    }
+
+    ~Devector() {
+        data_.DestroyN(Data(), size_);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает общее число ячеек буфера, включая свободные ячейки с обеих сторон
+    size_t GetCapacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Возвращает число свободных ячеек перед первым элементом
+    size_t GetFrontCapacity() const noexcept {
+        return front_;
+    }
+
+    // Возвращает число свободных ячеек после последнего элемента
+    size_t GetBackCapacity() const noexcept {
+        return data_.Capacity() - front_ - size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // В проверяемом режиме index >= size считается ошибкой
+    Type& operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return data_[front_ + index];
+    }
+
+    const Type& operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return data_[front_ + index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[front_ + index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[front_ + index];
+    }
+
+    // Возвращает указатель на первый элемент. Элементы непрерывны, как в SimpleVector
+    Type* Data() noexcept {
+        return data_ + front_;
+    }
+
+    const Type* Data() const noexcept {
+        return data_ + front_;
+    }
+
+    // Для арифметических типов поиск векторизован (см. simd_kernels.h)
+    Iterator Find(const Type& value) noexcept(simd::kHasKernels<Type>) {
+        return Data() + simd::Find(Data(), size_, value);
+    }
+
+    ConstIterator Find(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Data() + simd::Find(Data(), size_, value);
+    }
+
+    bool Contains(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Find(value) != cend();
+    }
+
+    size_t Count(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return simd::Count(Data(), size_, value);
+    }
+
+    // Удаляет все элементы, не изменяя вместимость
+    void Clear() noexcept {
+        data_.DestroyN(Data(), size_);
+        size_ = 0;
+    }
+
+    // Увеличивает вместимость до new_capacity, сохраняя свободное место перед элементами.
+    // Прирост достаётся концу вектора
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Relocate(new_capacity, front_);
+        }
+    }
+
+    // Гарантирует не меньше count свободных ячеек перед первым элементом,
+    // чтобы следующие count вызовов PushFront не перемещали элементы
+    void ReserveFront(size_t count) {
+        if (count > front_) {
+            Relocate(count + size_ + GetBackCapacity(), count);
+        }
+    }
+
+    // Освобождает свободные ячейки с обеих сторон
+    void ShrinkToFit() {
+        if (GetCapacity() > size_) {
+            Relocate(size_, 0);
+        }
+    }
+
+    // Изменяет размер, добавляя или удаляя элементы в конце.
+    // Новые элементы инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            data_.DestroyN(Data() + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            if (new_size - size_ > GetBackCapacity()) {
+                MakeRoom(new_size - size_, false);
+            }
+            data_.ConstructN(Data() + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    void PushFront(const Type& item) {
+        EmplaceFront(item);
+    }
+
+    void PushFront(Type&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (GetBackCapacity() == 0) {
+            return EmplaceWithRoom(false, std::forward<Args>(args)...);
+        }
+        Type* place = data_ + (front_ + size_);
+        data_.Construct(place, std::forward<Args>(args)...);
+        ++size_;
+        return *place;
+    }
+
+    template <typename... Args>
+    Type& EmplaceFront(Args&&... args) {
+        if (front_ == 0) {
+            return EmplaceWithRoom(true, std::forward<Args>(args)...);
+        }
+        Type* place = data_ + (front_ - 1);
+        data_.Construct(place, std::forward<Args>(args)...);
+        --front_;
+        ++size_;
+        return *place;
+    }
+
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            data_.Destroy(Data() + (size_ - 1));
+            --size_;
+        }
+    }
+
+    void PopFront() noexcept {
+        if (size_ > 0) {
+            data_.Destroy(Data());
+            ++front_;
+            --size_;
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент из args перед позицией pos, сдвигая на одну ячейку
+    // более короткую из частей вектора. Возвращает итератор на новый элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = OffsetOf(pos);
+        if (offset == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return Data() + offset;
+        }
+        if (offset == 0) {
+            return &EmplaceFront(std::forward<Args>(args)...);
+        }
+        const bool at_front = offset < size_ - offset;
+        // args могут ссылаться на элемент вектора, поэтому объект создаётся до сдвига
+        alignas(Type) unsigned char temp[sizeof(Type)];
+        Type* temp_obj = reinterpret_cast<Type*>(temp);
+        data_.Construct(temp_obj, std::forward<Args>(args)...);
+        try {
+            if (at_front ? front_ == 0 : GetBackCapacity() == 0) {
+                MakeRoom(1, at_front);
+            }
+            Type* first = Data();
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                if (at_front) {
+                    RecordMoves<Type>(offset);
+                    RelocateOverlappingN(first, offset, first - 1);
+                    UninitializedRelocateN(temp_obj, 1, first + (offset - 1));
+                    --front_;
+                } else {
+                    RecordMoves<Type>(size_ - offset);
+                    RelocateOverlappingN(first + offset, size_ - offset, first + (offset + 1));
+                    UninitializedRelocateN(temp_obj, 1, first + offset);
+                }
+                ++size_;
+                return Data() + offset;
+            } else if (at_front) {
+                RecordMoves<Type>(offset);
+                data_.Construct(first - 1, std::move(*first));
+                --front_;
+                ++size_;
+                std::move(first + 1, first + offset, first);
+                first[offset - 1] = std::move(*temp_obj);
+            } else {
+                RecordMoves<Type>(size_ - offset);
+                data_.Construct(first + size_, std::move(first[size_ - 1]));
+                ++size_;
+                std::move_backward(first + offset, first + (size_ - 2), first + (size_ - 1));
+                first[offset] = std::move(*temp_obj);
+            }
+        } catch (...) {
+            data_.Destroy(temp_obj);
+            throw;
+        }
+        data_.Destroy(temp_obj);
+        return Data() + offset;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        SIMPLE_VECTOR_CHECK(OffsetOf(pos) < size_, "erasing the end iterator");
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая более короткую из оставшихся частей.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t offset = OffsetOf(first);
+        const size_t last_offset = OffsetOf(last);
+        SIMPLE_VECTOR_CHECK(offset <= last_offset, "erasing a reversed range");
+        const size_t count = last_offset - offset;
+        if (count == 0) {
+            return Data() + offset;
+        }
+        Type* begin = Data();
+        if (offset < size_ - last_offset) {
+            // Элементы перед удаляемыми сдвигаются вправо, освобождая ячейки в начале
+            RecordMoves<Type>(offset);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                data_.DestroyN(begin + offset, count);
+                RelocateOverlappingN(begin, offset, begin + count);
+            } else {
+                std::move_backward(begin, begin + offset, begin + last_offset);
+                data_.DestroyN(begin, count);
+            }
+            front_ += count;
+        } else {
+            RecordMoves<Type>(size_ - last_offset);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                data_.DestroyN(begin + offset, count);
+                RelocateOverlappingN(begin + last_offset, size_ - last_offset, begin + offset);
+            } else {
+                Type* new_end = std::move(begin + last_offset, begin + size_, begin + offset);
+                data_.DestroyN(new_end, count);
+            }
+        }
+        size_ -= count;
+        return Data() + offset;
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+    void swap(Devector& other) noexcept {
+        data_.swap(other.data_);
+        std::swap(front_, other.front_);
+        std::swap(size_, other.size_);
+    }
+
+private:
+
+    // Сконструированы только ячейки [front_, front_ + size_)
+    RawMemory<Type, Allocator> data_;
+    size_t front_ = 0;
+    size_t size_ = 0;
+
+    // Переводит итератор в индекс. В проверяемом режиме итератор должен указывать в вектор
+    size_t OffsetOf(ConstIterator pos) const noexcept(!kVectorChecked) {
+        const size_t offset = static_cast<size_t>(pos - Data());
+        SIMPLE_VECTOR_CHECK(offset <= size_, "iterator does not point into the vector");
+        return offset;
+    }
+
+    // Освобождает не меньше count ячеек перед элементами (at_front) или после них.
+    // Если свободных ячеек с избытком хватает, элементы сдвигаются, и свободное место
+    // сверх count делится между сторонами поровну. Иначе буфер перевыделяется
+    void MakeRoom(size_t count, bool at_front) {
+        const size_t free = GetCapacity() - size_;
+        if constexpr (kShiftsInPlace) {
+            if (free >= count + size_) {
+                const size_t spare = (free - count) / 2;
+                Shift(at_front ? free - spare : spare);
+                return;
+            }
+        }
+        if (at_front) {
+            const size_t back = GetBackCapacity();
+            const size_t new_capacity = GrownCapacity(count + size_ + back);
+            Relocate(new_capacity, new_capacity - size_ - back);
+        } else {
+            Relocate(GrownCapacity(front_ + size_ + count), front_);
+        }
+    }
+
+    // Конструирует элемент из args с той стороны, где нет места, и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceWithRoom(bool at_front, Args&&... args) {
+        // args могут ссылаться на элемент, который переместится, поэтому объект создаётся заранее
+        alignas(Type) unsigned char temp[sizeof(Type)];
+        Type* temp_obj = reinterpret_cast<Type*>(temp);
+        data_.Construct(temp_obj, std::forward<Args>(args)...);
+        try {
+            MakeRoom(1, at_front);
+        } catch (...) {
+            data_.Destroy(temp_obj);
+            throw;
+        }
+        Type* place = at_front ? data_ + (front_ - 1) : data_ + (front_ + size_);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            UninitializedRelocateN(temp_obj, 1, place);
+        } else {
+            try {
+                data_.Construct(place, std::move(*temp_obj));
+            } catch (...) {
+                data_.Destroy(temp_obj);
+                throw;
+            }
+            data_.Destroy(temp_obj);
+        }
+        if (at_front) {
+            --front_;
+        }
+        ++size_;
+        return *place;
+    }
+
+    // Переносит элементы внутри буфера так, чтобы первый оказался в ячейке new_front
+    void Shift(size_t new_front) noexcept {
+        Type* from = data_ + front_;
+        Type* to = data_ + new_front;
+        RecordMoves<Type>(size_);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            RelocateOverlappingN(from, size_, to);
+        } else if (new_front < front_) {
+            for (size_t i = 0; i < size_; ++i) {
+                data_.Construct(to + i, std::move(from[i]));
+                data_.Destroy(from + i);
+            }
+        } else {
+            // При сдвиге вправо перекрывающиеся ячейки освобождаются с конца
+            for (size_t i = size_; i-- > 0;) {
+                data_.Construct(to + i, std::move(from[i]));
+                data_.Destroy(from + i);
+            }
+        }
+        front_ = new_front;
+    }
+
+    // Переносит элементы в новый буфер из new_capacity ячеек, начиная с ячейки new_front.
+    // Если перенос бросил исключение, вектор не изменяется
+    void Relocate(size_t new_capacity, size_t new_front) {
+        RawMemory<Type, Allocator> new_data(new_capacity, data_.GetAllocator());
+        RecordRegrowth<Type>(new_capacity);
+        new_data.RelocateN(Data(), size_, new_data + new_front);
+        data_.swap(new_data);
+        front_ = new_front;
+    }
+
+    // Вместимость после роста, когда в буфере должно поместиться required ячеек
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type)), required);
+    }
+
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    return simd::Equal(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    if constexpr (simd::kHasKernels<Type>) {
+        return simd::LexicographicalLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+    } else {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const Devector<Type, Allocator, GrowthPolicy>& lhs, const Devector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs < rhs);
+}
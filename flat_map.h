@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "sorted_search.h"
+
+// Ассоциативный массив на двух отсортированных SimpleVector: ключи и значения хранятся
+// раздельно, поэтому поиск просматривает только плотный массив ключей, а значения
+// читаются один раз по найденному индексу:
+//
+//     FlatMap<int, string> names = {{2, "two"}, {1, "one"}};
+//     names.Insert(pairs.begin(), pairs.end());  // одна сортировка и одно слияние
+//     if (const string* name = names.Find(1)) { ... }
+//
+// Как и у FlatSet, поиск — O(log n), одиночные вставка и удаление — O(n), а пары
+// выгоднее добавлять диапазоном. При равных ключах остаётся пара, добавленная раньше.
+// Layout задаёт раскладку для поиска (см. sorted_search.h). Allocator выделяет память
+// ключам, а для значений и индекса поиска он пересвязывается на их типы
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Layout = SortedLayout,
+          typename Allocator = std::allocator<Key>>
+class FlatMap {
+    using Index = typename Layout::template Index<Key, Allocator>;
+    using ValueAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Value>;
+    using OrderAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+public:
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& compare) : compare_(compare) {
+    }
+
+    explicit FlatMap(const Allocator& allocator) : FlatMap(Compare(), allocator) {
+    }
+
+    FlatMap(const Compare& compare, const Allocator& allocator)
+            : keys_(allocator)
+            , values_(ValueAllocator(allocator))
+            , compare_(compare)
+            , index_(allocator) {
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return keys_.GetAllocator();
+    }
+
+    FlatMap(std::initializer_list<std::pair<Key, Value>> init, const Compare& compare = Compare())
+            : FlatMap(init.begin(), init.end(), compare) {
+    }
+
+    // Создаёт словарь из пар диапазона [first, last)
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    FlatMap(InputIt first, InputIt last, const Compare& compare = Compare()) : compare_(compare) {
+        Insert(first, last);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+        index_.Build(keys_.Data(), 0);
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    // Возвращают отсортированные ключи и значения в том же порядке
+    SimpleSpan<const Key> GetKeys() const noexcept {
+        return {keys_.Data(), keys_.GetSize()};
+    }
+
+    SimpleSpan<Value> GetValues() noexcept {
+        return {values_.Data(), values_.GetSize()};
+    }
+
+    SimpleSpan<const Value> GetValues() const noexcept {
+        return {values_.Data(), values_.GetSize()};
+    }
+
+    // Возвращает указатель на значение ключа key или nullptr
+    Value* Find(const Key& key) {
+        const size_t offset = FindOffset(key);
+        return offset != keys_.GetSize() ? &values_[offset] : nullptr;
+    }
+
+    const Value* Find(const Key& key) const {
+        const size_t offset = FindOffset(key);
+        return offset != keys_.GetSize() ? &values_[offset] : nullptr;
+    }
+
+    bool Contains(const Key& key) const {
+        return FindOffset(key) != keys_.GetSize();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        return const_cast<Value&>(static_cast<const FlatMap*>(this)->At(key));
+    }
+
+    const Value& At(const Key& key) const {
+        const Value* value = Find(key);
+        if (value == nullptr) {
+            throw std::out_of_range("Key not found");
+        }
+        return *value;
+    }
+
+    // Возвращает значение ключа key, вставляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        return *Emplace(key).first;
+    }
+
+    // Если ключа нет, вставляет его со значением, сконструированным из args.
+    // Возвращает указатель на значение ключа и признак того, что вставка произошла
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> Emplace(K&& key, Args&&... args) {
+        const size_t offset = index_.LowerBound(keys_.Data(), keys_.GetSize(), key, compare_);
+        if (offset < keys_.GetSize() && !compare_(key, keys_[offset])) {
+            return {&values_[offset], false};
+        }
+        keys_.Insert(keys_.cbegin() + offset, std::forward<K>(key));
+        try {
+            values_.Emplace(values_.cbegin() + offset, std::forward<Args>(args)...);
+        } catch (...) {
+            keys_.Erase(keys_.cbegin() + offset);
+            throw;
+        }
+        index_.Build(keys_.Data(), keys_.GetSize());
+        return {&values_[offset], true};
+    }
+
+    std::pair<Value*, bool> Insert(const Key& key, const Value& value) {
+        return Emplace(key, value);
+    }
+
+    std::pair<Value*, bool> Insert(Key&& key, Value&& value) {
+        return Emplace(std::move(key), std::move(value));
+    }
+
+    // Вставляет пару или заменяет значение имеющегося ключа
+    template <typename V>
+    Value& InsertOrAssign(const Key& key, V&& value) {
+        auto [place, inserted] = Emplace(key, std::forward<V>(value));
+        if (!inserted) {
+            *place = std::forward<V>(value);
+        }
+        return *place;
+    }
+
+    // Вставляет пары диапазона [first, last): дописывает ключи и значения в конец
+    // столбцов, сортирует новые пары, сливает их с имеющимися и удаляет повторы.
+    // O(n + m log (n + m))
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    void Insert(InputIt first, InputIt last) {
+        const size_t old_size = keys_.GetSize();
+        if constexpr (kIsForwardIterator<InputIt>) {
+            // Каждый столбец дописывается одной вставкой SimpleVector
+            keys_.Append(ColumnIterator<InputIt, true>(first), ColumnIterator<InputIt, true>(last));
+            try {
+                values_.Append(ColumnIterator<InputIt, false>(first), ColumnIterator<InputIt, false>(last));
+            } catch (...) {
+                keys_.Erase(keys_.cbegin() + old_size, keys_.cend());
+                throw;
+            }
+        } else {
+            for (; first != last; ++first) {
+                const auto& entry = *first;
+                keys_.PushBack(entry.first);
+                try {
+                    values_.PushBack(entry.second);
+                } catch (...) {
+                    keys_.PopBack();
+                    throw;
+                }
+            }
+        }
+        MergeTail(old_size);
+    }
+
+    void Insert(std::initializer_list<std::pair<Key, Value>> init) {
+        Insert(init.begin(), init.end());
+    }
+
+    // Удаляет пару с ключом key и возвращает число удалённых пар
+    size_t Erase(const Key& key) {
+        const size_t offset = FindOffset(key);
+        if (offset == keys_.GetSize()) {
+            return 0;
+        }
+        keys_.Erase(keys_.cbegin() + offset);
+        values_.Erase(values_.cbegin() + offset);
+        index_.Build(keys_.Data(), keys_.GetSize());
+        return 1;
+    }
+
+    // Вызывает fn(key, value) для всех пар в порядке ключей. Ключи изменять нельзя
+    template <typename Fn>
+    void ForEach(Fn fn) {
+        for (size_t i = 0; i < keys_.GetSize(); ++i) {
+            fn(std::as_const(keys_[i]), values_[i]);
+        }
+    }
+
+    template <typename Fn>
+    void ForEach(Fn fn) const {
+        for (size_t i = 0; i < keys_.GetSize(); ++i) {
+            fn(keys_[i], values_[i]);
+        }
+    }
+
+    void swap(FlatMap& other) noexcept {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(compare_, other.compare_);
+        std::swap(index_, other.index_);
+    }
+
+private:
+
+    // Ключи без повторов, упорядоченные по compare_, и значения в том же порядке
+    SimpleVector<Key, Allocator> keys_;
+    SimpleVector<Value, ValueAllocator> values_;
+    [[no_unique_address]] Compare compare_ = {};
+    Index index_;
+
+    // Возвращает индекс ключа key или GetSize(), если его нет
+    size_t FindOffset(const Key& key) const {
+        const size_t offset = index_.LowerBound(keys_.Data(), keys_.GetSize(), key, compare_);
+        return offset < keys_.GetSize() && !compare_(key, keys_[offset]) ? offset : keys_.GetSize();
+    }
+
+    // Итератор по ключам или значениям диапазона пар
+    template <typename It, bool kKeys>
+    class ColumnIterator {
+        using Entry = typename std::iterator_traits<It>::reference;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::conditional_t<kKeys, Key, Value>;
+        using difference_type = typename std::iterator_traits<It>::difference_type;
+        using reference = std::conditional_t<kKeys, decltype((std::declval<Entry>().first)),
+                                             decltype((std::declval<Entry>().second))>;
+        using pointer = std::remove_reference_t<reference>*;
+
+        explicit ColumnIterator(It it) : it_(it) {
+        }
+
+        reference operator*() const {
+            if constexpr (kKeys) {
+                return (*it_).first;
+            } else {
+                return (*it_).second;
+            }
+        }
+
+        ColumnIterator& operator++() {
+            ++it_;
+            return *this;
+        }
+
+        ColumnIterator operator++(int) {
+            ColumnIterator copy = *this;
+            ++it_;
+            return copy;
+        }
+
+        bool operator==(const ColumnIterator& other) const {
+            return it_ == other.it_;
+        }
+
+        bool operator!=(const ColumnIterator& other) const {
+            return it_ != other.it_;
+        }
+
+    private:
+        It it_;
+    };
+
+    // Упорядочивает пары, начиная с sorted_size, и сливает их с отсортированным началом.
+    // Сортируется перестановка новых пар; из них отбрасываются повторы и ключи, которые
+    // уже есть в начале, а оставшиеся переносятся во временные столбцы размером с
+    // добавленное. Затем слияние идёт с конца на месте, как std::merge в свободный хвост
+    void MergeTail(size_t sorted_size) {
+        const size_t size = keys_.GetSize();
+        if (sorted_size != size) {
+            SimpleVector<size_t, OrderAllocator> order(size - sorted_size, OrderAllocator(keys_.GetAllocator()));
+            std::iota(order.begin(), order.end(), sorted_size);
+            std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) {
+                return compare_(keys_[lhs], keys_[rhs]);
+            });
+
+            SimpleVector<Key, Allocator> tail_keys(keys_.GetAllocator());
+            SimpleVector<Value, ValueAllocator> tail_values(values_.GetAllocator());
+            tail_keys.Reserve(order.GetSize());
+            tail_values.Reserve(order.GetSize());
+            for (const size_t from : order) {
+                const Key& key = keys_[from];
+                if (!tail_keys.IsEmpty() && !compare_(tail_keys[tail_keys.GetSize() - 1], key)) {
+                    continue;
+                }
+                const size_t place = BranchlessLowerBound(keys_.Data(), sorted_size, key, compare_);
+                if (place < sorted_size && !compare_(key, keys_[place])) {
+                    continue;
+                }
+                tail_keys.PushBack(std::move(keys_[from]));
+                tail_values.PushBack(std::move(values_[from]));
+            }
+
+            size_t old_end = sorted_size;
+            size_t tail_end = tail_keys.GetSize();
+            size_t write = sorted_size + tail_end;
+            keys_.Erase(keys_.cbegin() + write, keys_.cend());
+            values_.Erase(values_.cbegin() + write, values_.cend());
+            while (tail_end > 0) {
+                --write;
+                if (old_end > 0 && compare_(tail_keys[tail_end - 1], keys_[old_end - 1])) {
+                    --old_end;
+                    keys_[write] = std::move(keys_[old_end]);
+                    values_[write] = std::move(values_[old_end]);
+                } else {
+                    --tail_end;
+                    keys_[write] = std::move(tail_keys[tail_end]);
+                    values_[write] = std::move(tail_values[tail_end]);
+                }
+            }
+        }
+        index_.Build(keys_.Data(), keys_.GetSize());
+    }
+
+};
+
+template <typename Key, typename Value, typename Compare, typename Layout, typename Allocator>
+bool operator==(const FlatMap<Key, Value, Compare, Layout, Allocator>& lhs, const FlatMap<Key, Value, Compare, Layout, Allocator>& rhs) {
+    return lhs.GetSize() == rhs.GetSize()
+           && std::equal(lhs.GetKeys().begin(), lhs.GetKeys().end(), rhs.GetKeys().begin())
+           && std::equal(lhs.GetValues().begin(), lhs.GetValues().end(), rhs.GetValues().begin());
+}
+
+template <typename Key, typename Value, typename Compare, typename Layout, typename Allocator>
+bool operator!=(const FlatMap<Key, Value, Compare, Layout, Allocator>& lhs, const FlatMap<Key, Value, Compare, Layout, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "sorted_search.h"
+#include "vector_checks.h"
+
+// Упорядоченное множество на отсортированном SimpleVector. Ключи лежат подряд, поэтому
+// поиск не ходит по указателям, как std::set, а обход читает память последовательно:
+//
+//     FlatSet<int> ids = {5, 1, 3};
+//     ids.Insert(values.begin(), values.end());  // одна сортировка и одно слияние
+//     if (ids.Contains(3)) { ... }
+//
+// Поиск — O(log n), одиночная вставка и удаление — O(n) из-за сдвига. Поэтому таблицу
+// выгоднее собирать целиком: конструктор из диапазона и Insert(first, last) дописывают
+// ключи в конец за одну вставку SimpleVector, сортируют их и сливают с имеющимися.
+// Повторы отбрасываются, при равенстве остаётся ключ, добавленный раньше.
+// Layout задаёт раскладку для поиска (см. sorted_search.h)
+template <typename Key, typename Compare = std::less<Key>, typename Layout = SortedLayout,
+          typename Allocator = std::allocator<Key>>
+class FlatSet {
+    using Index = typename Layout::template Index<Key, Allocator>;
+
+public:
+
+    using Iterator = const Key*;
+    using ConstIterator = const Key*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& compare) : compare_(compare) {
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& compare = Compare())
+            : FlatSet(init.begin(), init.end(), compare) {
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    FlatSet(InputIt first, InputIt last, const Compare& compare = Compare()) : compare_(compare) {
+        Insert(first, last);
+    }
+
+    // Забирает ключи вектора, затем сортирует их и удаляет повторы
+    explicit FlatSet(SimpleVector<Key, Allocator> keys, const Compare& compare = Compare())
+            : keys_(std::move(keys))
+            , compare_(compare)
+            , index_(keys_.GetAllocator()) {
+        MergeTail(0);
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        index_.Build(keys_.Data(), 0);
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    // Возвращает отсортированные ключи
+    SimpleSpan<const Key> GetKeys() const noexcept {
+        return {keys_.Data(), keys_.GetSize()};
+    }
+
+    // Отдаёт отсортированные ключи, оставляя множество пустым
+    SimpleVector<Key, Allocator> Extract() noexcept {
+        SimpleVector<Key, Allocator> keys = std::move(keys_);
+        index_.Build(keys_.Data(), 0);
+        return keys;
+    }
+
+    // Возвращает указатель на первый ключ, не меньший key
+    ConstIterator LowerBound(const Key& key) const {
+        return keys_.Data() + index_.LowerBound(keys_.Data(), keys_.GetSize(), key, compare_);
+    }
+
+    // Возвращает указатель на первый ключ, больший key
+    ConstIterator UpperBound(const Key& key) const {
+        ConstIterator it = LowerBound(key);
+        return it != end() && !compare_(key, *it) ? it + 1 : it;
+    }
+
+    // Возвращает указатель на ключ, равный key, или end()
+    ConstIterator Find(const Key& key) const {
+        ConstIterator it = LowerBound(key);
+        return it != end() && !compare_(key, *it) ? it : end();
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    size_t Count(const Key& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    // Вставляет key, если его нет. Возвращает указатель на ключ множества, равный key,
+    // и признак того, что вставка произошла
+    std::pair<ConstIterator, bool> Insert(const Key& key) {
+        return InsertOne(key);
+    }
+
+    std::pair<ConstIterator, bool> Insert(Key&& key) {
+        return InsertOne(std::move(key));
+    }
+
+    // Вставляет ключи диапазона [first, last): дописывает их в конец одной вставкой,
+    // сортирует, сливает с имеющимися и удаляет повторы. O((n + m) + m log m)
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    void Insert(InputIt first, InputIt last) {
+        const size_t old_size = keys_.GetSize();
+        keys_.Append(first, last);
+        MergeTail(old_size);
+    }
+
+    void Insert(std::initializer_list<Key> init) {
+        Insert(init.begin(), init.end());
+    }
+
+    // Удаляет ключ, равный key, и возвращает число удалённых ключей
+    size_t Erase(const Key& key) {
+        ConstIterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    // Удаляет ключ в позиции pos и возвращает указатель на следующий
+    ConstIterator Erase(ConstIterator pos) {
+        const size_t offset = static_cast<size_t>(pos - keys_.Data());
+        SIMPLE_VECTOR_CHECK(offset < keys_.GetSize(), "erasing a key out of range");
+        keys_.Erase(keys_.cbegin() + offset);
+        index_.Build(keys_.Data(), keys_.GetSize());
+        return keys_.Data() + offset;
+    }
+
+    ConstIterator begin() const noexcept {
+        return keys_.Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return keys_.Data() + keys_.GetSize();
+    }
+
+    void swap(FlatSet& other) noexcept {
+        keys_.swap(other.keys_);
+        std::swap(compare_, other.compare_);
+        std::swap(index_, other.index_);
+    }
+
+private:
+
+    // Ключи без повторов, упорядоченные по compare_
+    SimpleVector<Key, Allocator> keys_;
+    [[no_unique_address]] Compare compare_ = {};
+    Index index_;
+
+    template <typename K>
+    std::pair<ConstIterator, bool> InsertOne(K&& key) {
+        const size_t offset = index_.LowerBound(keys_.Data(), keys_.GetSize(), key, compare_);
+        if (offset < keys_.GetSize() && !compare_(key, keys_[offset])) {
+            return {keys_.Data() + offset, false};
+        }
+        keys_.Insert(keys_.cbegin() + offset, std::forward<K>(key));
+        index_.Build(keys_.Data(), keys_.GetSize());
+        return {keys_.Data() + offset, true};
+    }
+
+    // Сортирует ключи, начиная с sorted_size, сливает их с отсортированным началом
+    // и удаляет повторы. Устойчивые алгоритмы оставляют из равных ключей самый ранний
+    void MergeTail(size_t sorted_size) {
+        Key* first = keys_.Data();
+        Key* middle = first + sorted_size;
+        Key* last = first + keys_.GetSize();
+        if (middle != last) {
+            std::stable_sort(middle, last, compare_);
+            std::inplace_merge(first, middle, last, compare_);
+            Key* new_end = std::unique(first, last, [this](const Key& lhs, const Key& rhs) {
+                return !compare_(lhs, rhs);
+            });
+            keys_.Erase(keys_.cbegin() + (new_end - first), keys_.cend());
+        }
+        index_.Build(keys_.Data(), keys_.GetSize());
+    }
+
+};
+
+template <typename Key, typename Compare, typename Layout, typename Allocator>
+bool operator==(const FlatSet<Key, Compare, Layout, Allocator>& lhs, const FlatSet<Key, Compare, Layout, Allocator>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename Compare, typename Layout, typename Allocator>
+bool operator!=(const FlatSet<Key, Compare, Layout, Allocator>& lhs, const FlatSet<Key, Compare, Layout, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
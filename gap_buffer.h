@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "vector_checks.h"
+#include "vector_stats.h"
+
+// Буфер с разрывом (gap buffer) для серий правок около одной позиции, например текста
+// под курсором. Свободные ячейки буфера образуют разрыв в месте последней правки, поэтому
+// Insert и Erase рядом с ним стоят O(1), а не сдвигают весь хвост, как в SimpleVector:
+//
+//     GapBuffer<char> text = ...;
+//     text.Insert(cursor, 'a');
+//     text.Insert(cursor + 1, 'b');
+//     text.Erase(cursor - 3);
+//     SimpleSpan<char> contiguous = text.Compact();
+//
+// Правка в другой позиции сначала переносит разрыв туда за O(расстояния). Элементы
+// адресуются индексами без учёта разрыва. Compact() переносит разрыв в конец и возвращает
+// непрерывный span элементов, а GetHead() и GetTail() позволяют читать части до и после
+// разрыва без перемещений
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class GapBuffer {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+public:
+
+    using allocator_type = Allocator;
+
+    GapBuffer() noexcept = default;
+
+    explicit GapBuffer(const Allocator& allocator) noexcept : data_(allocator) {
+    }
+
+    GapBuffer(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : GapBuffer(init.begin(), init.end(), allocator) {
+    }
+
+    // Создаёт буфер из элементов диапазона [first, last). Разрыв оказывается в конце
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    GapBuffer(InputIt first, InputIt last, const Allocator& allocator = Allocator()) : GapBuffer(allocator) {
+        Insert(0, first, last);
+    }
+
+    GapBuffer(const GapBuffer& other)
+            : GapBuffer(other, AllocatorTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+    }
+
+    // Копия занимает ровно other.GetSize() ячеек, разрыв в ней пуст
+    GapBuffer(const GapBuffer& other, const Allocator& allocator) : data_(other.GetSize(), allocator) {
+        const size_t head = other.gap_start_;
+        data_.CopyConstructN(other.data_.Get(), head, data_.Get());
+        try {
+            data_.CopyConstructN(other.data_ + other.gap_end_, other.GetCapacity() - other.gap_end_, data_ + head);
+        } catch (...) {
+            data_.DestroyN(data_.Get(), head);
+            throw;
+        }
+        gap_start_ = gap_end_ = data_.Capacity();
+    }
+
+    GapBuffer(GapBuffer&& other) noexcept
+            : data_(std::move(other.data_))
+            , gap_start_(std::exchange(other.gap_start_, 0))
+            , gap_end_(std::exchange(other.gap_end_, 0)) {
+    }
+
+    // Если аллокаторы не равны, элементы перемещаются по одному в новый буфер
+    // без разрыва, как при копировании
+    GapBuffer(GapBuffer&& other, const Allocator& allocator) : data_(allocator) {
+        if (data_.GetAllocator() == other.data_.GetAllocator()) {
+            data_ = std::move(other.data_);
+            gap_start_ = std::exchange(other.gap_start_, 0);
+            gap_end_ = std::exchange(other.gap_end_, 0);
+        } else {
+            RawMemory<Type, Allocator> new_data(other.GetSize(), allocator);
+            const size_t head = other.gap_start_;
+            new_data.MoveOrCopyConstructN(other.data_.Get(), head, new_data.Get());
+            try {
+                new_data.MoveOrCopyConstructN(other.data_ + other.gap_end_, other.GetCapacity() - other.gap_end_,
+                                              new_data + head);
+            } catch (...) {
+                new_data.DestroyN(new_data.Get(), head);
+                throw;
+            }
+            data_.swap(new_data);
+            gap_start_ = gap_end_ = data_.Capacity();
+            other.Clear();
+        }
+    }
+
+    // Аллокатор *this сохраняется
+    GapBuffer& operator=(const GapBuffer& other) {
+        if (this != &other) {
+            GapBuffer copy(other, data_.GetAllocator());
+            swap(copy);
+        }
+        return *this;
+    }
+
+    // Аллокатор *this сохраняется. Если аллокаторы не равны, элементы перемещаются по одному
+    GapBuffer& operator=(GapBuffer&& other) noexcept(AllocatorTraits::is_always_equal::value) {
+        if (this != &other) {
+            GapBuffer temp(std::move(other), data_.GetAllocator());
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~GapBuffer() {
+        Clear();
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    size_t GetSize() const noexcept {
+        return data_.Capacity() - GetGapSize();
+    }
+
+    size_t GetCapacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Возвращает число свободных ячеек в разрыве, то есть вставок, не требующих перевыделения
+    size_t GetGapSize() const noexcept {
+        return gap_end_ - gap_start_;
+    }
+
+    // Возвращает индекс элемента, перед которым находится разрыв
+    size_t GetCursor() const noexcept {
+        return gap_start_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // В проверяемом режиме index >= size считается ошибкой
+    Type& operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < GetSize(), "index out of range");
+        return data_[ToPhysical(index)];
+    }
+
+    const Type& operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < GetSize(), "index out of range");
+        return data_[ToPhysical(index)];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[ToPhysical(index)];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[ToPhysical(index)];
+    }
+
+    // Возвращает элементы перед разрывом [0, GetCursor())
+    SimpleSpan<Type> GetHead() noexcept {
+        return {data_.Get(), gap_start_};
+    }
+
+    SimpleSpan<const Type> GetHead() const noexcept {
+        return {data_.Get(), gap_start_};
+    }
+
+    // Возвращает элементы после разрыва [GetCursor(), GetSize())
+    SimpleSpan<Type> GetTail() noexcept {
+        return {data_ + gap_end_, GetCapacity() - gap_end_};
+    }
+
+    SimpleSpan<const Type> GetTail() const noexcept {
+        return {data_ + gap_end_, GetCapacity() - gap_end_};
+    }
+
+    // Переносит разрыв в конец и возвращает все элементы одним непрерывным span.
+    // Стоит O(GetSize() - GetCursor()): после серии правок у конца почти бесплатен.
+    // Span действителен до следующей правки
+    SimpleSpan<Type> Compact() {
+        MoveCursor(GetSize());
+        return GetHead();
+    }
+
+    // Переносит разрыв так, чтобы он оказался перед элементом index, за O(|index - GetCursor()|).
+    // Если перемещение элемента бросило исключение, разрыв остаётся между уже
+    // перенесёнными и остальными элементами, порядок элементов не нарушается
+    void MoveCursor(size_t index) {
+        SIMPLE_VECTOR_CHECK(index <= GetSize(), "cursor out of range");
+        if (gap_start_ == gap_end_) {
+            gap_start_ = gap_end_ = index;
+            return;
+        }
+        if (index < gap_start_) {
+            const size_t count = gap_start_ - index;
+            RecordMoves<Type>(count);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                RelocateOverlappingN(data_ + index, count, data_ + (gap_end_ - count));
+                gap_start_ -= count;
+                gap_end_ -= count;
+            } else {
+                // Каждый шаг переносит один элемент через разрыв и сохраняет инварианты буфера
+                while (gap_start_ > index) {
+                    data_.Construct(data_ + (gap_end_ - 1), std::move(data_[gap_start_ - 1]));
+                    data_.Destroy(data_ + (gap_start_ - 1));
+                    --gap_start_;
+                    --gap_end_;
+                }
+            }
+        } else if (index > gap_start_) {
+            const size_t count = index - gap_start_;
+            RecordMoves<Type>(count);
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                RelocateOverlappingN(data_ + gap_end_, count, data_ + gap_start_);
+                gap_start_ += count;
+                gap_end_ += count;
+            } else {
+                while (gap_start_ < index) {
+                    data_.Construct(data_ + gap_start_, std::move(data_[gap_end_]));
+                    data_.Destroy(data_ + gap_end_);
+                    ++gap_start_;
+                    ++gap_end_;
+                }
+            }
+        }
+    }
+
+    // Удаляет все элементы, не изменяя вместимость
+    void Clear() noexcept {
+        data_.DestroyN(data_.Get(), gap_start_);
+        data_.DestroyN(data_ + gap_end_, GetCapacity() - gap_end_);
+        gap_start_ = 0;
+        gap_end_ = GetCapacity();
+    }
+
+    // Увеличивает вместимость до new_capacity, не перемещая разрыв
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Relocate(new_capacity);
+        }
+    }
+
+    // Конструирует элемент из args перед элементом index и возвращает ссылку на него
+    template <typename... Args>
+    Type& Emplace(size_t index, Args&&... args) {
+        SIMPLE_VECTOR_CHECK(index <= GetSize(), "insertion position out of range");
+        if (gap_start_ == gap_end_) {
+            // args могут ссылаться на элемент буфера, поэтому объект создаётся до перевыделения
+            alignas(Type) unsigned char temp[sizeof(Type)];
+            Type* temp_obj = reinterpret_cast<Type*>(temp);
+            data_.Construct(temp_obj, std::forward<Args>(args)...);
+            try {
+                Relocate(GrownCapacity(GetSize() + 1));
+                MoveCursor(index);
+                data_.Construct(data_ + gap_start_, std::move(*temp_obj));
+            } catch (...) {
+                data_.Destroy(temp_obj);
+                throw;
+            }
+            data_.Destroy(temp_obj);
+        } else if (index == gap_start_) {
+            data_.Construct(data_ + gap_start_, std::forward<Args>(args)...);
+        } else {
+            // Перенос разрыва переместит элемент, на который могут ссылаться args
+            alignas(Type) unsigned char temp[sizeof(Type)];
+            Type* temp_obj = reinterpret_cast<Type*>(temp);
+            data_.Construct(temp_obj, std::forward<Args>(args)...);
+            try {
+                MoveCursor(index);
+                data_.Construct(data_ + gap_start_, std::move(*temp_obj));
+            } catch (...) {
+                data_.Destroy(temp_obj);
+                throw;
+            }
+            data_.Destroy(temp_obj);
+        }
+        return data_[gap_start_++];
+    }
+
+    void Insert(size_t index, const Type& value) {
+        Emplace(index, value);
+    }
+
+    void Insert(size_t index, Type&& value) {
+        Emplace(index, std::move(value));
+    }
+
+    // Вставляет элементы диапазона [first, last) перед элементом index.
+    // Диапазон не должен ссылаться на элементы буфера. Если конструирование бросило
+    // исключение, уже вставленные элементы остаются в буфере
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    void Insert(size_t index, InputIt first, InputIt last) {
+        SIMPLE_VECTOR_CHECK(index <= GetSize(), "insertion position out of range");
+        if constexpr (kIsForwardIterator<InputIt>) {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > GetGapSize()) {
+                Relocate(GrownCapacity(GetSize() + count));
+            }
+        }
+        MoveCursor(index);
+        for (; first != last; ++first) {
+            if (gap_start_ == gap_end_) {
+                Relocate(GrownCapacity(GetSize() + 1));
+            }
+            data_.Construct(data_ + gap_start_, *first);
+            ++gap_start_;
+        }
+    }
+
+    void PushBack(const Type& value) {
+        Emplace(GetSize(), value);
+    }
+
+    void PushBack(Type&& value) {
+        Emplace(GetSize(), std::move(value));
+    }
+
+    void Erase(size_t index) {
+        Erase(index, index + 1);
+    }
+
+    // Удаляет элементы [first, last), расширяя разрыв. Если разрыв стоит на first
+    // или на last, элементы не перемещаются
+    void Erase(size_t first, size_t last) {
+        SIMPLE_VECTOR_CHECK(first <= last && last <= GetSize(), "erased range out of range");
+        if (first == last) {
+            return;
+        }
+        if (last == gap_start_) {
+            data_.DestroyN(data_ + first, last - first);
+            gap_start_ = first;
+            return;
+        }
+        MoveCursor(first);
+        data_.DestroyN(data_ + gap_end_, last - first);
+        gap_end_ += last - first;
+    }
+
+    void swap(GapBuffer& other) noexcept {
+        data_.swap(other.data_);
+        std::swap(gap_start_, other.gap_start_);
+        std::swap(gap_end_, other.gap_end_);
+    }
+
+private:
+
+    // Сконструированы ячейки [0, gap_start_) и [gap_end_, capacity)
+    RawMemory<Type, Allocator> data_;
+    size_t gap_start_ = 0;
+    size_t gap_end_ = 0;
+
+    // Переводит индекс элемента в номер ячейки буфера
+    size_t ToPhysical(size_t index) const noexcept {
+        return index < gap_start_ ? index : index + GetGapSize();
+    }
+
+    // Переносит элементы в новый буфер из new_capacity ячеек, сохраняя положение разрыва.
+    // Если перенос бросил исключение, буфер не изменяется
+    void Relocate(size_t new_capacity) {
+        RawMemory<Type, Allocator> new_data(new_capacity, data_.GetAllocator());
+        RecordRegrowth<Type>(new_capacity);
+        const size_t tail = GetCapacity() - gap_end_;
+        const size_t new_gap_end = new_capacity - tail;
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            new_data.RelocateN(data_.Get(), gap_start_, new_data.Get());
+            new_data.RelocateN(data_ + gap_end_, tail, new_data + new_gap_end);
+        } else {
+            new_data.MoveOrCopyConstructN(data_.Get(), gap_start_, new_data.Get());
+            try {
+                new_data.MoveOrCopyConstructN(data_ + gap_end_, tail, new_data + new_gap_end);
+            } catch (...) {
+                new_data.DestroyN(new_data.Get(), gap_start_);
+                throw;
+            }
+            data_.DestroyN(data_.Get(), gap_start_);
+            data_.DestroyN(data_ + gap_end_, tail);
+        }
+        data_.swap(new_data);
+        gap_end_ = new_gap_end;
+    }
+
+    // Вместимость после роста, когда в буфере должно поместиться required элементов
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type)), required);
+    }
+
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Политики роста вместимости SimpleVector. Политика — тип со статическим методом
+//
+//     static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size);
+//
+// который по текущей вместимости capacity возвращает новую вместимость не меньше
+// required. element_size — размер элемента в байтах, он нужен политикам,
+// округляющим размер блока памяти. Без constexpr политика работает везде, кроме
+// константных выражений (см. vector_constexpr.h)
+
+// Удваивает вместимость. Меньше всего перераспределений, но до 50% памяти может пустовать
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity * 2, required);
+    }
+};
+
+// Увеличивает вместимость в 1.5 раза: не больше трети памяти пустует, а освобождённые
+// при росте блоки со временем могут быть переиспользованы следующими выделениями
+struct OneAndHalfGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity + capacity / 2, required);
+    }
+};
+
+// Увеличивает вместимость примерно в золотое сечение (13/8 = 1.625)
+struct GoldenRatioGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(capacity + capacity / 2 + capacity / 8, required);
+    }
+};
+
+// Растёт по политике Base, а затем округляет размер блока в байтах вверх до класса
+// размеров типичного аллокатора: до размера страницы — четыре класса на каждую степень
+// двойки (как в jemalloc), дальше — до целого числа страниц PageSize. Ячейки, которые
+// аллокатор всё равно выделил бы, становятся доступной вместимостью
+template <typename Base = OneAndHalfGrowth, size_t PageSize = 4096>
+struct SizeClassGrowth {
+    static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        const size_t bytes = RoundToSizeClass(Base::NextCapacity(capacity, required, element_size) * element_size);
+        return std::max(bytes / element_size, required);
+    }
+
+    static constexpr size_t RoundToSizeClass(size_t bytes) noexcept {
+        if (bytes <= 16) {
+            return 16;
+        }
+        if (bytes >= PageSize) {
+            return (bytes + PageSize - 1) & ~(PageSize - 1);
+        }
+        // Шаг класса — четверть степени двойки, не превосходящей bytes
+        size_t power = 16;
+        while (power * 2 <= bytes) {
+            power *= 2;
+        }
+        const size_t step = power / 4;
+        return (bytes + step - 1) / step * step;
+    }
+};
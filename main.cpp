@@ -1,8 +1,35 @@
 #include "simple_vector.h"
+#include "small_vector.h"
+#include "parallel.h"
+#include "concurrent_simple_vector.h"
+#include "mapped_simple_vector.h"
+#include "serialization.h"
+#include "simple_span.h"
+#include "cow_simple_vector.h"
+#include "soa_vector.h"
+#include "aligned_allocator.h"
+#include "buffer_pool.h"
+#include "segmented_vector.h"
+#include "devector.h"
+#include "gap_buffer.h"
+#include "static_vector.h"
+#include "flat_set.h"
+#include "flat_map.h"
+#include "bit_vector.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <filesystem>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
 #include <numeric>
+#include <list>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -31,6 +58,201 @@ private:
     size_t x_;
 };
 
+// Считает живые объекты, чтобы проверить, что вектор не создаёт лишних элементов
+class CountedObj {
+public:
+    explicit CountedObj(int value)
+            : value_(value) {
+        ++alive;
+    }
+    CountedObj(const CountedObj& other)
+            : value_(other.value_) {
+        ++alive;
+    }
+    CountedObj& operator=(const CountedObj& other) = default;
+    ~CountedObj() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    static inline int alive = 0;
+
+private:
+    int value_;
+};
+
+// Запись из нескольких полей, которая считает каждое перемещение
+struct MoveCountedRecord {
+    MoveCountedRecord(int id, string name)
+            : id(id)
+            , name(move(name)) {
+    }
+    MoveCountedRecord(MoveCountedRecord&& other) noexcept
+            : id(other.id)
+            , name(move(other.name)) {
+        ++moves;
+    }
+    MoveCountedRecord& operator=(MoveCountedRecord&& other) noexcept {
+        id = other.id;
+        name = move(other.name);
+        ++moves;
+        return *this;
+    }
+
+    int id;
+    string name;
+
+    static inline int moves = 0;
+};
+
+// Считает живые объекты; присваивание бросает исключение, пока установлен throw_on_assign
+struct ThrowingAssignObj {
+    explicit ThrowingAssignObj(int value)
+            : value(value) {
+        ++alive;
+    }
+    ThrowingAssignObj(const ThrowingAssignObj& other)
+            : value(other.value) {
+        ++alive;
+    }
+    ThrowingAssignObj& operator=(const ThrowingAssignObj& other) {
+        if (throw_on_assign) {
+            throw runtime_error("assignment failed");
+        }
+        value = other.value;
+        return *this;
+    }
+    ~ThrowingAssignObj() {
+        --alive;
+    }
+
+    int value;
+
+    static inline int alive = 0;
+    static inline bool throw_on_assign = false;
+};
+
+// Вставляет элемент в середину вектора, сдвиг которого бросает исключение,
+// и проверяет, что все сконструированные объекты учтены в размере
+template <typename Vector>
+void CheckEmplaceShiftFailure(Vector& v) {
+    for (int i = 0; i < 4; ++i) {
+        v.EmplaceBack(i);
+    }
+    ThrowingAssignObj::throw_on_assign = true;
+    try {
+        v.Emplace(v.begin() + 1, 10);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    ThrowingAssignObj::throw_on_assign = false;
+    assert(ThrowingAssignObj::alive == static_cast<int>(v.GetSize()));
+    v.Clear();
+    assert(ThrowingAssignObj::alive == 0);
+}
+
+// Владеет значением в куче; объявлен тривиально перемещаемым через IsTriviallyRelocatable
+class Handle {
+public:
+    explicit Handle(int value)
+            : value_(new int(value)) {
+    }
+    Handle(Handle&& other) noexcept
+            : value_(exchange(other.value_, nullptr)) {
+    }
+    Handle& operator=(Handle&& other) noexcept {
+        delete exchange(value_, exchange(other.value_, nullptr));
+        return *this;
+    }
+    ~Handle() {
+        delete value_;
+    }
+    int GetValue() const {
+        return *value_;
+    }
+
+private:
+    int* value_;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
+// Аллокатор с идентификатором, который считает выделенные байты и передаётся
+// при копировании, перемещении и обмене контейнеров
+template <typename Type>
+struct TrackingAllocator {
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit TrackingAllocator(int id = 0, size_t* allocated = nullptr)
+            : id(id)
+            , allocated(allocated) {
+    }
+    template <typename Other>
+    TrackingAllocator(const TrackingAllocator<Other>& other)
+            : id(other.id)
+            , allocated(other.allocated) {
+    }
+
+    Type* allocate(size_t n) {
+        if (allocated != nullptr) {
+            *allocated += n * sizeof(Type);
+        }
+        return std::allocator<Type>().allocate(n);
+    }
+    void deallocate(Type* p, size_t n) {
+        if (allocated != nullptr) {
+            *allocated -= n * sizeof(Type);
+        }
+        std::allocator<Type>().deallocate(p, n);
+    }
+
+    bool operator==(const TrackingAllocator& other) const {
+        return id == other.id;
+    }
+    bool operator!=(const TrackingAllocator& other) const {
+        return id != other.id;
+    }
+
+    int id;
+    size_t* allocated;
+};
+
+// Бросает std::bad_alloc при каждом выделении, пока установлен fail
+template <typename Type>
+struct FlakyAllocator {
+    using value_type = Type;
+
+    FlakyAllocator() = default;
+    template <typename Other>
+    FlakyAllocator(const FlakyAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        if (FlakyAllocator<char>::fail) {
+            throw std::bad_alloc();
+        }
+        return std::allocator<Type>().allocate(n);
+    }
+    void deallocate(Type* p, size_t n) {
+        std::allocator<Type>().deallocate(p, n);
+    }
+
+    bool operator==(const FlakyAllocator&) const {
+        return true;
+    }
+    bool operator!=(const FlakyAllocator&) const {
+        return false;
+    }
+
+    static inline bool fail = false;
+};
+
 SimpleVector<int> GenerateVector(size_t size) {
     SimpleVector<int> v(size);
     iota(v.begin(), v.end(), 1);
@@ -149,6 +371,1843 @@ void TestNoncopiableErase() {
     cout << "Done!" << endl << endl;
 }
 
+void TestUninitializedStorage() {
+    cout << "Test uninitialized storage" << endl;
+    {
+        SimpleVector<CountedObj> v(Reserve(100));
+        assert(v.GetCapacity() == 100);
+        assert(CountedObj::alive == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(CountedObj(i));
+        }
+        assert(CountedObj::alive == 10);
+
+        v.PushBack(v[0]);
+        v.Insert(v.begin(), v[5]);
+        assert(v.GetSize() == 12);
+        assert(v[0].GetValue() == 5 && v[11].GetValue() == 0);
+        assert(CountedObj::alive == 12);
+
+        v.PopBack();
+        v.Erase(v.begin());
+        assert(CountedObj::alive == 10);
+
+        while (v.GetSize() > 4) {
+            v.PopBack();
+        }
+        assert(CountedObj::alive == 4);
+
+        v.Clear();
+        assert(CountedObj::alive == 0);
+        assert(v.GetCapacity() == 100);
+
+        v.PushBack(CountedObj(1));
+        SimpleVector<CountedObj> copy(v);
+        assert(CountedObj::alive == 2);
+        copy = SimpleVector<CountedObj>(3, CountedObj(7));
+        assert(CountedObj::alive == 4);
+    }
+    assert(CountedObj::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestEmplace() {
+    cout << "Test emplace" << endl;
+    SimpleVector<MoveCountedRecord> v(Reserve(10));
+    MoveCountedRecord::moves = 0;
+
+    MoveCountedRecord& back = v.EmplaceBack(1, "one"s);
+    assert(&back == &v[0]);
+    v.EmplaceBack(3, "three"s);
+    assert(MoveCountedRecord::moves == 0);
+
+    auto it = v.Emplace(v.end(), 4, "four"s);
+    assert(it == v.begin() + 2 && it->id == 4);
+    assert(MoveCountedRecord::moves == 0);
+
+    it = v.Emplace(v.begin() + 1, 2, "two"s);
+    assert(it == v.begin() + 1);
+    for (int i = 0; i < 4; ++i) {
+        assert(v[i].id == i + 1);
+    }
+    assert(v[1].name == "two"s && v[3].name == "four"s);
+
+    SimpleVector<string> strings;
+    for (int i = 0; i < 5; ++i) {
+        strings.EmplaceBack(3, 'a' + i);
+    }
+    strings.Emplace(strings.begin(), strings[4]);
+    assert(strings.GetSize() == 6);
+    assert(strings[0] == "eee"s && strings[1] == "aaa"s);
+
+    // Сдвиг бросил исключение после конструирования нового последнего элемента
+    SimpleVector<ThrowingAssignObj> throwing(Reserve(8));
+    CheckEmplaceShiftFailure(throwing);
+    cout << "Done!" << endl << endl;
+}
+
+void TestTrivialRelocation() {
+    cout << "Test trivial relocation" << endl;
+    static_assert(kIsTriviallyRelocatable<int>);
+    static_assert(kIsTriviallyRelocatable<unique_ptr<string>>);
+    static_assert(!kIsTriviallyRelocatable<string>);
+
+    SimpleVector<int> ints;
+    vector<int> expected;
+    for (int i = 0; i < 100; ++i) {
+        ints.Insert(ints.begin() + ints.GetSize() / 2, i);
+        expected.insert(expected.begin() + expected.size() / 2, i);
+    }
+    ints.Insert(ints.begin(), ints[99]);
+    expected.insert(expected.begin(), expected[99]);
+    ints.Erase(ints.begin() + 1);
+    expected.erase(expected.begin() + 1);
+    ints.Erase(ints.end() - 1);
+    expected.pop_back();
+    assert(equal(ints.begin(), ints.end(), expected.begin(), expected.end()));
+
+    SimpleVector<unique_ptr<int>> pointers;
+    for (int i = 0; i < 10; ++i) {
+        pointers.Insert(pointers.begin(), make_unique<int>(i));
+    }
+    pointers.Erase(pointers.begin() + 3);
+    assert(pointers.GetSize() == 9);
+    assert(*pointers[0] == 9 && *pointers[3] == 5 && *pointers[8] == 0);
+
+    SimpleVector<Handle> handles;
+    for (int i = 0; i < 10; ++i) {
+        handles.EmplaceBack(i);
+    }
+    handles.Emplace(handles.begin() + 5, 42);
+    handles.Erase(handles.begin());
+    assert(handles.GetSize() == 10);
+    assert(handles[0].GetValue() == 1 && handles[4].GetValue() == 42 && handles[9].GetValue() == 9);
+    cout << "Done!" << endl << endl;
+}
+
+void TestReallocGrowth() {
+    cout << "Test realloc growth" << endl;
+    static_assert(RawMemory<int>::kCanReallocate);
+    static_assert(!RawMemory<string>::kCanReallocate);
+
+    SimpleVector<int> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(i);
+    }
+    // Ссылка на собственный элемент при росте остаётся корректной
+    while (v.GetSize() != v.GetCapacity()) {
+        v.PushBack(v[0]);
+    }
+    v.PushBack(v[1]);
+    v.Insert(v.begin(), v[v.GetSize() - 1]);
+    assert(v[0] == 1 && v[1] == 0 && v[v.GetSize() - 1] == 1);
+    for (int i = 0; i < 1000; ++i) {
+        assert(v[i + 1] == i);
+    }
+
+    // Размер буфера в байтах не помещается в size_t: вектор не меняется
+    const size_t too_many = std::numeric_limits<size_t>::max() / sizeof(int) + 1;
+    const size_t capacity = v.GetCapacity();
+    try {
+        v.Reserve(too_many);
+        assert(false);
+    } catch (const std::bad_array_new_length&) {
+    }
+    assert(v.GetCapacity() == capacity && v[1] == 0);
+    SimpleVector<int> empty;
+    try {
+        empty.Reserve(too_many);
+        assert(false);
+    } catch (const std::bad_array_new_length&) {
+    }
+    assert(empty.GetCapacity() == 0);
+    try {
+        RawMemory<int> raw(too_many);
+        assert(false);
+    } catch (const std::bad_array_new_length&) {
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestAllocators() {
+    cout << "Test allocators" << endl;
+    {
+        size_t first_bytes = 0;
+        size_t second_bytes = 0;
+        using Vector = SimpleVector<string, TrackingAllocator<string>>;
+        Vector first(3, "first"s, TrackingAllocator<string>(1, &first_bytes));
+        Vector second({"a"s, "b"s}, TrackingAllocator<string>(2, &second_bytes));
+        assert(first_bytes == 3 * sizeof(string) && second_bytes == 2 * sizeof(string));
+
+        first.PushBack("grow"s);
+        assert(first_bytes == 6 * sizeof(string));
+
+        // propagate_on_container_copy_assignment: first переходит на аллокатор second
+        first = second;
+        assert(first.GetAllocator().id == 2 && first == second);
+        assert(first_bytes == 0 && second_bytes == 4 * sizeof(string));
+
+        Vector third(TrackingAllocator<string>(3));
+        third = move(first);
+        assert(third.GetAllocator().id == 2 && third.GetSize() == 2 && first.IsEmpty());
+
+        Vector copy(third);
+        assert(copy.GetAllocator().id == 2 && copy == third);
+        copy.swap(first);
+        assert(first.GetSize() == 2 && copy.IsEmpty());
+    }
+    {
+        char arena[4096];
+        std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+        PmrSimpleVector<std::pmr::string> v(&resource);
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack("string that does not fit into the small buffer "s + to_string(i));
+        }
+        v.Insert(v.begin(), v[9]);
+        // Строки получают аллокатор вектора и тоже живут в арене
+        assert(v[0].get_allocator().resource() == &resource);
+        assert(v[0] == v[10]);
+
+        PmrSimpleVector<std::pmr::string> other;
+        other = v;
+        assert(other.GetAllocator().resource() == std::pmr::get_default_resource());
+        assert(other == v);
+        other = move(v);
+        assert(other.GetSize() == 11 && v.IsEmpty());
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSmallVector() {
+    cout << "Test small vector" << endl;
+    {
+        SmallVector<int, 4> v = {1, 2, 3};
+        assert(v.IsInline() && v.GetCapacity() == 4);
+        v.PushBack(4);
+        assert(v.IsInline());
+        v.Insert(v.begin(), v[3]);
+        assert(!v.IsInline() && v.GetCapacity() == 8);
+        assert((v == SmallVector<int, 4>{4, 1, 2, 3, 4}));
+        v.Erase(v.begin() + 1);
+        v.Resize(6);
+        assert((v == SmallVector<int, 4>{4, 2, 3, 4, 0, 0}));
+        assert((SmallVector<int, 4>{1, 2} < SmallVector<int, 4>{1, 3}));
+    }
+    {
+        SmallVector<ThrowingAssignObj, 8> throwing;
+        CheckEmplaceShiftFailure(throwing);
+    }
+    {
+        SmallVector<string, 2> inline_strings = {"a"s, "b"s};
+        SmallVector<string, 2> moved(move(inline_strings));
+        assert(moved.IsInline() && moved.GetSize() == 2 && moved[1] == "b"s);
+        assert(inline_strings.IsEmpty() && inline_strings.IsInline());
+
+        SmallVector<string, 2> heap_strings(5, "x"s);
+        assert(!heap_strings.IsInline());
+        const string* heap_data = heap_strings.begin();
+        SmallVector<string, 2> stolen(move(heap_strings));
+        assert(stolen.begin() == heap_data && heap_strings.IsInline());
+
+        stolen.swap(moved);
+        assert(stolen.GetSize() == 2 && moved.GetSize() == 5 && moved.begin() == heap_data);
+        moved = stolen;
+        assert(moved == stolen);
+    }
+    {
+        SmallVector<NoCopyObj, 3> v;
+        for (size_t i = 0; i < 5; ++i) {
+            v.PushBack(NoCopyObj(i));
+        }
+        v.Insert(v.begin() + 2, NoCopyObj(42));
+        v.Erase(v.begin());
+        assert(v.GetSize() == 5 && v[1].GetX() == 42 && v[4].GetX() == 4);
+        v.PopBack();
+        SmallVector<NoCopyObj, 3> moved = move(v);
+        assert(moved.GetSize() == 4 && v.IsEmpty());
+    }
+    {
+        SmallVector<CountedObj, 2> v;
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        v.EmplaceBack(3);
+        SmallVector<CountedObj, 2> copy(v);
+        assert(CountedObj::alive == 6);
+    }
+    assert(CountedObj::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+// Возвращает последовательность вместимостей при добавлении count элементов по одному
+template <typename Vector>
+vector<size_t> CollectCapacities(Vector& v, size_t count) {
+    vector<size_t> capacities;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(static_cast<int>(i));
+        if (capacities.empty() || capacities.back() != v.GetCapacity()) {
+            capacities.push_back(v.GetCapacity());
+        }
+    }
+    return capacities;
+}
+
+void TestGrowthPolicies() {
+    cout << "Test growth policies" << endl;
+    {
+        SimpleVector<int> v;
+        assert((CollectCapacities(v, 9) == vector<size_t>{1, 2, 4, 8, 16}));
+    }
+    {
+        SimpleVector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        assert((CollectCapacities(v, 10) == vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+    }
+    {
+        SimpleVector<int, std::allocator<int>, GoldenRatioGrowth> v;
+        assert((CollectCapacities(v, 14) == vector<size_t>{1, 2, 3, 4, 6, 9, 14}));
+    }
+    {
+        // Блоки 16, 24 и 40 байт: 6 * 1.5 = 9 int (36 байт) округляются до класса 40 байт
+        SimpleVector<int, std::allocator<int>, SizeClassGrowth<>> v;
+        assert((CollectCapacities(v, 9) == vector<size_t>{4, 6, 10}));
+        using Rounding = SizeClassGrowth<>;
+        assert(Rounding::RoundToSizeClass(100) == 112);
+        assert(Rounding::RoundToSizeClass(5000) == 8192);
+    }
+    {
+        SimpleVector<int> v;
+        v.SetGrowthHint(1000);
+        assert((CollectCapacities(v, 1000) == vector<size_t>{1000}));
+        v.PushBack(0);
+        assert(v.GetCapacity() == 2000);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestShrinkAndResize() {
+    cout << "Test shrink to fit and resize" << endl;
+    {
+        SimpleVector<int> v;
+        size_t reallocations = 0;
+        for (size_t i = 1; i <= 1000; ++i) {
+            const size_t capacity = v.GetCapacity();
+            v.Resize(i);
+            reallocations += capacity != v.GetCapacity();
+        }
+        assert(reallocations == 11);
+        assert(v.GetCapacity() == 1024);
+
+        v.Resize(700);
+        v.ShrinkToFit(0.5);
+        assert(v.GetCapacity() == 1024);
+        v.Resize(100);
+        v.ShrinkToFit(0.5);
+        assert(v.GetCapacity() == 100);
+        for (int i = 0; i < 100; ++i) {
+            assert(v[i] == 0);
+        }
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 0);
+        v.PushBack(1);
+        assert(v.GetSize() == 1 && v[0] == 1);
+    }
+    {
+        SimpleVector<string> v(Reserve(100));
+        v.PushBack("kept"s);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 1 && v[0] == "kept"s);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestBulkInsert() {
+    cout << "Test bulk insert" << endl;
+    {
+        SimpleVector<int> v = {1, 2, 3};
+        const int extra[] = {10, 11, 12, 13};
+        auto it = v.Insert(v.begin() + 1, begin(extra), end(extra));
+        assert(it == v.begin() + 1);
+        assert((v == SimpleVector<int>{1, 10, 11, 12, 13, 2, 3}));
+
+        v.Insert(v.end(), 2, 7);
+        v.Append(begin(extra), begin(extra) + 1);
+        assert((v == SimpleVector<int>{1, 10, 11, 12, 13, 2, 3, 7, 7, 10}));
+
+        // Диапазон из самого вектора
+        v.Insert(v.begin(), v.begin() + 5, v.end());
+        assert((v == SimpleVector<int>{2, 3, 7, 7, 10, 1, 10, 11, 12, 13, 2, 3, 7, 7, 10}));
+        v.Insert(v.begin() + 1, 3, v[0]);
+        assert(v[1] == 2 && v[3] == 2 && v[4] == 3);
+
+        v.Assign({5, 6});
+        assert((v == SimpleVector<int>{5, 6}) && v.GetCapacity() >= 18);
+        v.Assign(v.begin() + 1, v.end());
+        assert((v == SimpleVector<int>{6}));
+        v.Assign(3, v[0]);
+        assert((v == SimpleVector<int>{6, 6, 6}));
+    }
+    {
+        SimpleVector<string> v = {"a"s, "e"s};
+        const list<string> middle = {"b"s, "c"s, "d"s};
+        v.Insert(v.begin() + 1, middle.begin(), middle.end());
+        assert((v == SimpleVector<string>{"a"s, "b"s, "c"s, "d"s, "e"s}));
+        v.Reserve(20);
+        v.Insert(v.begin() + 2, {"x"s, "y"s});
+        v.Insert(v.begin(), 2, v[6]);
+        assert((v == SimpleVector<string>{"e"s, "e"s, "a"s, "b"s, "x"s, "y"s, "c"s, "d"s, "e"s}));
+
+        istringstream input("p q r");
+        v.Insert(v.begin() + 1, istream_iterator<string>(input), istream_iterator<string>());
+        assert(v[0] == "e"s && v[1] == "p"s && v[3] == "r"s && v[4] == "e"s && v.GetSize() == 12);
+
+        SimpleVector<string> from_list(middle.begin(), middle.end());
+        v.Assign(from_list.begin(), from_list.end());
+        assert(v == from_list);
+    }
+    {
+        SimpleVector<CountedObj> v(Reserve(2));
+        v.Insert(v.begin(), 3, CountedObj(1));
+        v.Insert(v.begin() + 1, 2, CountedObj(2));
+        assert(CountedObj::alive == 5);
+        v.Assign(1, CountedObj(3));
+        assert(CountedObj::alive == 1 && v[0].GetValue() == 3);
+    }
+    assert(CountedObj::alive == 0);
+    {
+        // Поворот в середину бросает исключение: вставленные элементы
+        // уже учтены в размере и разрушаются вместе с вектором
+        SimpleVector<ThrowingAssignObj> v(Reserve(16));
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        const ThrowingAssignObj src[] = {ThrowingAssignObj(10), ThrowingAssignObj(11)};
+        ThrowingAssignObj::throw_on_assign = true;
+        try {
+            v.Insert(v.begin() + 1, begin(src), end(src));
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        ThrowingAssignObj::throw_on_assign = false;
+        assert(ThrowingAssignObj::alive == static_cast<int>(v.GetSize()) + 2);
+        v.Clear();
+        assert(ThrowingAssignObj::alive == 2);
+    }
+    assert(ThrowingAssignObj::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestBulkErase() {
+    cout << "Test bulk erase" << endl;
+    {
+        SimpleVector<int> v = {0, 1, 2, 3, 4, 5, 6};
+        auto it = v.Erase(v.begin() + 1, v.begin() + 4);
+        assert(*it == 4);
+        assert((v == SimpleVector<int>{0, 4, 5, 6}));
+        assert(v.Erase(v.begin(), v.begin()) == v.begin() && v.GetSize() == 4);
+        v.Erase(v.begin() + 2, v.end());
+        assert((v == SimpleVector<int>{0, 4}));
+
+        SimpleVector<int> numbers(100);
+        iota(numbers.begin(), numbers.end(), 0);
+        assert(EraseIf(numbers, [](int x) { return x % 3 != 0; }) == 66);
+        assert(numbers.GetSize() == 34 && numbers[33] == 99);
+    }
+    {
+        SimpleVector<CountedObj> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Erase(v.begin(), v.begin() + 2);
+        assert(CountedObj::alive == 8 && v[0].GetValue() == 2);
+        EraseIf(v, [](const CountedObj& obj) { return obj.GetValue() % 2 == 0; });
+        assert(CountedObj::alive == 4 && v[0].GetValue() == 3 && v[3].GetValue() == 9);
+    }
+    assert(CountedObj::alive == 0);
+    {
+        SimpleVector<NoCopyObj> v;
+        for (size_t i = 0; i < 6; ++i) {
+            v.PushBack(NoCopyObj(i));
+        }
+        v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(v.GetSize() == 4 && v[1].GetX() == 3);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Счётчики ведутся только при сборке с -DSIMPLE_VECTOR_STATS, иначе остаются нулевыми
+void TestStats() {
+    cout << "Test stats" << endl;
+    struct Tracked {
+        int value;
+    };
+    ResetVectorStats<Tracked>();
+    {
+        SimpleVector<Tracked> v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack({i});
+        }
+        v.Insert(v.begin() + 2, {42});
+        v.Erase(v.begin());
+        SimpleVector<Tracked> copy(v);
+    }
+    const VectorStatsSnapshot stats = GetVectorStats<Tracked>();
+    if constexpr (kVectorStatsEnabled) {
+        // Рост 1 -> 2 -> 4 -> 8 -> 16 и буфер копии
+        assert(stats.allocations == 6);
+        assert(stats.regrowths == 5);
+        assert(stats.peak_capacity == 16);
+        assert(stats.bytes_allocated == (1 + 2 + 4 + 8 + 16 + 8) * sizeof(Tracked));
+        // realloc переносит буфер без поэлементных перемещений: сдвиги хвоста при Insert и Erase
+        assert(stats.element_moves == 6 + 8);
+        assert(stats.element_copies == 8);
+        assert(GetGlobalVectorStats().allocations >= stats.allocations);
+    } else {
+        assert(stats.allocations == 0 && stats.element_moves == 0 && stats.peak_capacity == 0);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Сверяет векторизованные сравнения и поиск со стандартными алгоритмами
+// на длинах, не кратных размеру вектора, и с одним отличием в каждой позиции
+template <typename Type>
+void CheckSimdKernels() {
+    for (size_t size = 0; size < 70; ++size) {
+        SimpleVector<Type> a(size);
+        for (size_t i = 0; i < size; ++i) {
+            a[i] = static_cast<Type>(i % 7);
+        }
+        const vector<Type> expected(a.begin(), a.end());
+        assert(a.Count(Type(3)) == static_cast<size_t>(count(expected.begin(), expected.end(), Type(3))));
+        assert(a.Find(Type(5)) - a.begin() == find(expected.begin(), expected.end(), Type(5)) - expected.begin());
+        assert(!a.Contains(Type(9)) && a.Find(Type(9)) == a.end());
+        for (size_t pos = 0; pos < size; ++pos) {
+            SimpleVector<Type> b(a);
+            assert(a == b && !(a < b) && !(b < a));
+            b[pos] = Type(9);
+            assert(a != b && a < b && b > a);
+            assert(b.Find(Type(9)) == b.begin() + pos && b.Count(Type(9)) == 1);
+            b.PopBack();
+            assert(a != b);
+            assert((a < b) == lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+        }
+    }
+}
+
+void TestSimd() {
+    cout << "Test simd" << endl;
+    CheckSimdKernels<char>();
+    CheckSimdKernels<uint8_t>();
+    CheckSimdKernels<int16_t>();
+    CheckSimdKernels<int>();
+    CheckSimdKernels<uint64_t>();
+    CheckSimdKernels<float>();
+    CheckSimdKernels<double>();
+    {
+        // Знаковые типы сравниваются как знаковые, хотя ядра работают с беззнаковыми дорожками
+        SimpleVector<int> negative = {1, -1};
+        SimpleVector<int> positive = {1, 1};
+        assert(negative < positive);
+    }
+    {
+        // -0.0 равен 0.0, NaN не равен ничему и не решает исход лексикографического сравнения
+        const double nan = numeric_limits<double>::quiet_NaN();
+        SimpleVector<double> zeros(20, 0.0);
+        SimpleVector<double> negative_zeros(20, -0.0);
+        assert(zeros == negative_zeros && zeros.Count(-0.0) == 20);
+        SimpleVector<double> a(20, 1.0);
+        a[3] = nan;
+        SimpleVector<double> b(a);
+        assert(a != b && !a.Contains(nan));
+        b[10] = 2.0;
+        assert(a < b && !(b < a));
+        assert((a < b) == lexicographical_compare(a.begin(), a.end(), b.begin(), b.end()));
+    }
+    {
+        SimpleVector<string> words = {"a"s, "b"s, "a"s};
+        assert(words.Count("a"s) == 2 && words.Find("b"s) == words.begin() + 1 && !words.Contains("c"s));
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestParallel() {
+    cout << "Test parallel" << endl;
+    // Порог 1 заставляет делить даже небольшие векторы между потоками,
+    // а число потоков задаётся явно, чтобы тест не зависел от машины
+    SetParallelConcurrency(4);
+    {
+        SimpleVector<int> v(1000);
+        ParallelFill(v, 7, 1);
+        assert(v.Count(7) == 1000);
+        iota(v.begin(), v.end(), 0);
+        ParallelTransform(v, v, [](int x) { return x * 2; }, 1);
+        assert(v[999] == 1998);
+        assert(ParallelReduce(v, 0LL, plus<>(), 1) == 999LL * 1000);
+        SimpleVector<string> words(v.GetSize());
+        ParallelTransform(v, words, [](int x) { return to_string(x); }, 1);
+        assert(words[10] == "20"s);
+        assert(ParallelReduce(SimpleVector<string>{"a"s, "b"s, "c"s}, ""s, plus<>(), 1) == "abc"s);
+    }
+    for (size_t size : {0, 1, 2, 3, 17, 1000, 4099}) {
+        SimpleVector<int> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<int>((i * 7919) % 1009);
+        }
+        vector<int> expected(v.begin(), v.end());
+        sort(expected.begin(), expected.end(), greater<>());
+        ParallelSort(v, greater<>(), 1);
+        assert(equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    }
+    {
+        SimpleVector<int> v(100);
+        try {
+            ParallelTransform(v, v, [](int x) -> int { throw invalid_argument(to_string(x)); }, 1);
+            assert(false);
+        } catch (const invalid_argument&) {
+        }
+    }
+    {
+        // Буфер больше kParallelConstructBytes заполняется и копируется несколькими потоками
+        const size_t size = 2 * kParallelConstructBytes / sizeof(uint64_t) + 3;
+        SimpleVector<uint64_t> filled(size, 42);
+        assert(filled.Count(42) == size);
+        SimpleVector<uint64_t> zeros(size);
+        assert(zeros.Count(0) == size);
+        iota(filled.begin(), filled.end(), 0);
+        SimpleVector<uint64_t> copy(filled);
+        assert(copy == filled && copy[size - 1] == size - 1);
+        zeros = filled;
+        assert(zeros == filled);
+    }
+    SetParallelConcurrency(0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestConcurrentVector() {
+    cout << "Test concurrent vector" << endl;
+    {
+        ConcurrentSimpleVector<int> v;
+        const int kThreads = 8;
+        const int kPerThread = 5000;
+        vector<const int*> first_items(kThreads);
+        vector<thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&v, &first_items, t] {
+                first_items[t] = &v.PushBack(t * kPerThread);
+                for (int i = 1; i < kPerThread; ++i) {
+                    v.EmplaceBack(t * kPerThread + i);
+                }
+            });
+        }
+        for (thread& worker : threads) {
+            worker.join();
+        }
+        assert(v.GetSize() == size_t(kThreads * kPerThread));
+        // Рост не перемещает уже добавленные элементы
+        for (int t = 0; t < kThreads; ++t) {
+            assert(*first_items[t] == t * kPerThread);
+        }
+        SimpleVector<int> frozen = v.Freeze();
+        assert(v.IsEmpty() && frozen.GetSize() == size_t(kThreads * kPerThread));
+        sort(frozen.begin(), frozen.end());
+        for (size_t i = 0; i < frozen.GetSize(); ++i) {
+            assert(frozen[i] == static_cast<int>(i));
+        }
+    }
+    {
+        ConcurrentSimpleVector<string> v;
+        v.Reserve(100);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(to_string(i));
+        }
+        assert(v[0] == "0"s && v[15] == "15"s && v[16] == "16"s && v[99] == "99"s);
+    }
+    {
+        // Ячейка, в которой конструктор бросил исключение, не разрушается и не попадает в Freeze
+        struct Picky {
+            explicit Picky(int value) : obj(value) {
+                if (value == 3) {
+                    throw invalid_argument("3");
+                }
+            }
+            CountedObj obj;
+        };
+        {
+            ConcurrentSimpleVector<Picky> v;
+            for (int i = 0; i < 40; ++i) {
+                try {
+                    v.EmplaceBack(i);
+                } catch (const invalid_argument&) {
+                }
+            }
+            assert(v.GetSize() == 40 && CountedObj::alive == 39);
+            SimpleVector<Picky> frozen = v.Freeze();
+            assert(frozen.GetSize() == 39 && frozen[3].obj.GetValue() == 4);
+        }
+        assert(CountedObj::alive == 0);
+    }
+    {
+        // Выделение сегмента провалилось, а затем удалось другому добавлению:
+        // ячейки провалившихся добавлений в этом сегменте пропускаются
+        ConcurrentSimpleVector<CountedObj, FlakyAllocator<CountedObj>> v;
+        for (int i = 0; i < 16; ++i) {
+            v.EmplaceBack(i);
+        }
+        FlakyAllocator<char>::fail = true;
+        for (int i = 16; i < 18; ++i) {
+            try {
+                v.EmplaceBack(i);
+                assert(false);
+            } catch (const bad_alloc&) {
+            }
+        }
+        FlakyAllocator<char>::fail = false;
+        for (int i = 18; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.GetSize() == 100 && CountedObj::alive == 98 && v[18].GetValue() == 18);
+        SimpleVector<CountedObj, FlakyAllocator<CountedObj>> frozen = v.Freeze();
+        assert(frozen.GetSize() == 98 && frozen[15].GetValue() == 15 && frozen[16].GetValue() == 18);
+        frozen.Clear();
+        assert(CountedObj::alive == 0);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestMappedVector() {
+    cout << "Test mapped vector" << endl;
+    struct Record {
+        uint64_t id;
+        double weight;
+    };
+    const string path = (filesystem::temp_directory_path() / ("simple_vector_mapped_" + to_string(::getpid()))).string();
+    filesystem::remove(path);
+    {
+        MappedSimpleVector<Record> records(path);
+        assert(records.IsEmpty() && !records.IsReadOnly());
+        for (uint64_t i = 0; i < 1000; ++i) {
+            records.PushBack({i, i * 0.5});
+        }
+        records.PushBack(records[10]);
+        assert(records.GetSize() == 1001 && records.GetCapacity() >= 1001);
+        records.Flush();
+    }
+    {
+        // Данные видны без чтения файла, в том числе нескольким отображениям сразу
+        const MappedSimpleVector<Record> first(path, MappedMode::kReadOnly);
+        const MappedSimpleVector<Record> second(path, MappedMode::kReadOnly);
+        assert(first.IsReadOnly() && first.GetSize() == 1001);
+        assert(first[999].id == 999 && first[999].weight == 499.5 && first[1000].id == 10);
+        assert(&first[0] != &second[0] && second[500].id == 500);
+        try {
+            first.At(1001);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        MappedSimpleVector<Record> records(path);
+        records.Resize(10);
+        records.ShrinkToFit();
+        assert(records.GetCapacity() == 10 && filesystem::file_size(path) == records.kDataOffset + 10 * sizeof(Record));
+        assert(records[0].id == 0 && records[9].id == 9);
+        records.Resize(20);
+        assert(records[19].id == 0 && records[9].id == 9);
+
+        records.Insert(records.begin() + 2, records[9]);
+        records.EmplaceBack(uint64_t(77), 1.5);
+        assert(records.GetSize() == 22 && records[2].id == 9 && records[3].id == 2);
+        assert(records[21].id == 77 && records[21].weight == 1.5);
+        records.Erase(records.begin() + 2);
+        records.Erase(records.begin() + 10, records.begin() + 20);
+        assert(records.GetSize() == 11 && records[2].id == 2 && records[9].id == 9 && records[10].id == 77);
+
+        // Длина файла не помещается в size_t: файл и вместимость не меняются
+        const size_t capacity = records.GetCapacity();
+        try {
+            records.Reserve(numeric_limits<size_t>::max() / sizeof(Record));
+            assert(false);
+        } catch (const bad_array_new_length&) {
+        }
+        assert(records.GetCapacity() == capacity && records[10].id == 77);
+    }
+    try {
+        MappedSimpleVector<int> wrong_type(path, MappedMode::kReadOnly);
+        assert(false);
+    } catch (const runtime_error&) {
+    }
+    filesystem::remove(path);
+    try {
+        MappedSimpleVector<Record> missing(path, MappedMode::kReadOnly);
+        assert(false);
+    } catch (const system_error& error) {
+        assert(error.code() == errc::no_such_file_or_directory);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSerialization() {
+    cout << "Test serialization" << endl;
+    {
+        SimpleVector<int> numbers(1000);
+        iota(numbers.begin(), numbers.end(), -500);
+        stringstream stream;
+        Serialize(stream, numbers);
+        SimpleVector<int> restored = {1, 2, 3};
+        Deserialize(stream, restored);
+        assert(restored == numbers);
+
+        // Представление читает элементы прямо из буфера, не копируя их
+        const string buffer = stream.str();
+        assert(buffer.size() == sizeof(SerializedHeader) + 1000 * sizeof(int));
+        SimpleVectorView<int> view(buffer.data(), buffer.size());
+        assert(view.GetSize() == 1000 && view[0] == -500 && view.At(999) == 499);
+        assert(view.GetSerializedSize() == buffer.size());
+        assert(reinterpret_cast<const char*>(view.begin()) == buffer.data() + sizeof(SerializedHeader));
+        assert(equal(view.begin(), view.end(), numbers.begin(), numbers.end()));
+
+        try {
+            SimpleVectorView<int> truncated(buffer.data(), buffer.size() - 1);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        try {
+            SimpleVectorView<double> wrong_type(buffer.data(), buffer.size());
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+    }
+    {
+        SimpleVector<SimpleVector<string>> nested = {{"a"s, ""s}, {}, {string(10000, 'x')}};
+        stringstream stream;
+        Serialize(stream, nested);
+        SimpleVector<SimpleVector<string>> restored;
+        Deserialize(stream, restored);
+        assert(restored == nested);
+
+        // Поток, оборванный посередине, не даёт прочитать мусор
+        const string bytes = stream.str();
+        stringstream truncated(bytes.substr(0, bytes.size() - 5));
+        try {
+            Deserialize(truncated, restored);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+    }
+    {
+        stringstream garbage("definitely not a vector, just text of some length");
+        SimpleVector<int> v;
+        try {
+            Deserialize(garbage, v);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+    }
+    cout << "Done!" << endl << endl;
+}
+
+// Принимает подпоследовательность без копирования
+int SumOf(SimpleSpan<const int> numbers) {
+    return accumulate(numbers.begin(), numbers.end(), 0);
+}
+
+void TestSpan() {
+    cout << "Test span" << endl;
+    SimpleVector<int> v(10);
+    iota(v.begin(), v.end(), 0);
+    {
+        assert(SumOf(v) == 45);
+        SimpleSpan all(v);
+        assert(all.GetSize() == 10 && all.Data() == &v[0]);
+        assert(SumOf(all.First(3)) == 3 && SumOf(all.Last(2)) == 17);
+        SimpleSpan<int> middle = all.Subspan(2, 3);
+        assert(middle.GetSize() == 3 && middle[0] == 2 && middle.At(2) == 4);
+        assert(all.Subspan(7).GetSize() == 3 && all.Subspan(10).IsEmpty());
+        try {
+            middle.At(3);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        // Изменения через SimpleSpan<int> видны в векторе
+        middle[0] = 20;
+        assert(v[2] == 20);
+        v[2] = 2;
+        assert(middle.Contains(3) && middle.Find(4) == &v[4] && all.Count(9) == 1);
+    }
+    {
+        const SimpleVector<int>& cv = v;
+        SimpleSpan view = cv;
+        static_assert(is_same_v<decltype(view), SimpleSpan<const int>>);
+        SimpleSpan<const int> from_mutable = SimpleSpan<int>(v);
+        assert(from_mutable.GetSize() == view.GetSize());
+        static_assert(!is_convertible_v<SimpleSpan<const int>, SimpleSpan<int>>);
+        static_assert(!is_convertible_v<const SimpleVector<int>&, SimpleSpan<int>>);
+    }
+    {
+        SimpleSpan<const int> span(v);
+        SimpleVector<int> prefix = {0, 1, 2};
+        assert(span.First(3) == prefix && prefix == span.First(3) && span.First(3) == span.Subspan(0, 3));
+        assert(span.First(2) < prefix && prefix > span.First(2) && span != prefix);
+        assert(span.First(3) <= prefix && span.First(3) >= prefix);
+        assert(SimpleSpan<int>(nullptr, 0) == SimpleSpan<const int>());
+
+        SimpleVector<string> words = {"b"s, "a"s};
+        SimpleSpan<const string> word_span = words;
+        assert(word_span == words && SimpleSpan<const string>(words).Last(1) < word_span);
+    }
+    {
+        // Параллельные алгоритмы работают с частью вектора
+        SimpleSpan<int> tail = SimpleSpan<int>(v).Last(5);
+        ParallelFill(tail, -1, 1);
+        assert(v[4] == 4 && v[5] == -1 && v.Count(-1) == 5);
+        SimpleVector<int> copy(tail.begin(), tail.end());
+        assert(copy.GetSize() == 5 && copy == tail);
+    }
+#if __cpp_lib_span >= 202002L
+    {
+        std::span<int> standard = SimpleSpan<int>(v);
+        assert(standard.size() == 10 && standard.data() == v.Data());
+        SimpleSpan<const int> back = standard;
+        assert(back == v);
+    }
+#endif
+    cout << "Done!" << endl << endl;
+}
+
+void TestCowVector() {
+    cout << "Test copy-on-write vector" << endl;
+    {
+        CowSimpleVector<int> table(10000, 1);
+        const int* shared = table.Get().Data();
+        CowSimpleVector<int> snapshot = table;
+        // Копия разделяет буфер, пока её не изменят
+        assert(table.UseCount() == 2 && snapshot.Get().Data() == shared);
+        assert(as_const(snapshot)[5] == 1 && snapshot.Count(1) == 10000 && snapshot.UseCount() == 2);
+        assert(snapshot == table && snapshot.SharesBufferWith(table));
+
+        snapshot[5] = 2;
+        assert(!table.IsShared() && !snapshot.IsShared() && snapshot.Get().Data() != shared);
+        assert(table[5] == 1 && snapshot[5] == 2 && table.Get().Data() == shared);
+        assert(table < snapshot && table != snapshot);
+    }
+    {
+        // Общий буфер с NaN не равен сам себе, как и SimpleVector<double>
+        const CowSimpleVector<double> values = {1.0, numeric_limits<double>::quiet_NaN()};
+        const CowSimpleVector<double> shared = values;
+        assert(shared.SharesBufferWith(values) && shared != values && values.Get() != values.Get());
+    }
+    {
+        CowSimpleVector<string> words = {"a"s, "c"s};
+        CowSimpleVector<string> copy = words;
+        // Позиция в общем буфере переносится в отделённую копию
+        copy.Insert(copy.cbegin() + 1, "b"s);
+        copy.PushBack("d"s);
+        copy.Erase(copy.cbegin());
+        assert((copy.Get() == SimpleVector<string>{"b"s, "c"s, "d"s}));
+        assert((words.Get() == SimpleVector<string>{"a"s, "c"s}));
+
+        CowSimpleVector<string> empty;
+        assert(empty.IsEmpty() && empty.UseCount() == 0 && empty.begin() == empty.end());
+        empty = words;
+        words.Clear();
+        assert(words.IsEmpty() && empty.GetSize() == 2 && !empty.IsShared());
+    }
+    {
+        SimpleVector<int> source = {1, 2, 3};
+        const int* data = source.Data();
+        CowSimpleVector<int> adopted(std::move(source));
+        assert(adopted.Get().Data() == data);
+    }
+    {
+        // Копии живут в разных потоках, последняя освобождает буфер
+        CowSimpleVector<string> shared;
+        for (int i = 0; i < 100; ++i) {
+            shared.PushBack(to_string(i));
+        }
+        vector<thread> readers;
+        atomic<size_t> total_length = 0;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([copy = shared, &total_length, t]() mutable {
+                size_t length = 0;
+                for (const string& word : as_const(copy)) {
+                    length += word.size();
+                }
+                if (t % 2 == 0) {
+                    copy.PushBack(to_string(t));
+                }
+                total_length += length;
+            });
+        }
+        for (thread& reader : readers) {
+            reader.join();
+        }
+        assert(total_length == 4 * 190 && shared.UseCount() == 1 && shared.GetSize() == 100);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestSoaVector() {
+    cout << "Test structure of arrays" << endl;
+    {
+        SoaVector<float, int, string> particles;
+        for (int i = 0; i < 100; ++i) {
+            particles.PushBack({static_cast<float>(i), i * 2, to_string(i)});
+        }
+        assert(particles.GetSize() == 100 && particles.GetCapacity() >= 100);
+        // Каждое поле хранится в собственном непрерывном столбце
+        SimpleSpan<int> doubled = particles.Get<1>();
+        assert(doubled.GetSize() == 100 && doubled[10] == 20 && doubled.Count(20) == 1);
+        assert(particles.Get<0>().Data() + 1 == &get<0>(particles[1]));
+        for (float& x : particles.Get<0>()) {
+            x += 0.5f;
+        }
+        auto [x, twice, name] = particles[7];
+        assert(x == 7.5f && twice == 14 && name == "7");
+
+        particles.Erase(0);
+        particles.Erase(10, 20);
+        assert(particles.GetSize() == 89 && get<2>(particles[0]) == "1" && get<2>(particles[10]) == "21");
+        // Строка, ссылающаяся на элементы самого вектора, добавляется и при росте
+        while (particles.GetSize() != particles.GetCapacity()) {
+            particles.PushBack({0.0f, 0, "filler"});
+        }
+        particles.EmplaceBack(get<0>(particles[0]), get<1>(particles[0]), get<2>(particles[0]));
+        assert(get<2>(particles[particles.GetSize() - 1]) == "1");
+
+        const SoaVector<float, int, string> copy = particles;
+        assert(copy.GetSize() == particles.GetSize() && get<2>(copy[10]) == "21" && get<2>(copy[100]) == "filler");
+        assert(copy.Get<1>() == particles.Get<1>());
+        particles.Resize(200);
+        assert(get<1>(particles[199]) == 0 && get<2>(particles[199]).empty());
+        particles.Clear();
+        assert(particles.IsEmpty() && copy.GetSize() != 0);
+    }
+    {
+        // Столбец копируемых элементов без noexcept-перемещения растёт копированием
+        CountedObj::alive = 0;
+        {
+            SoaVector<int, CountedObj> records;
+            for (int i = 0; i < 50; ++i) {
+                records.EmplaceBack(i, CountedObj(i));
+            }
+            assert(CountedObj::alive == 50 && get<1>(records[49]).GetValue() == 49);
+            records.Erase(5, 45);
+            assert(CountedObj::alive == 10 && get<1>(records[5]).GetValue() == 45);
+            SoaVector<int, CountedObj> moved = std::move(records);
+            assert(records.IsEmpty() && moved.GetSize() == 10 && CountedObj::alive == 10);
+        }
+        assert(CountedObj::alive == 0);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestAlignedAllocator() {
+    cout << "Test aligned allocator" << endl;
+    const auto is_aligned = [](const void* data, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(data) % alignment == 0;
+    };
+    {
+        AlignedSimpleVector<float> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(v.Data(), 64));
+        }
+        assert(v.Count(5.0f) == 1 && v[999] == 999.0f);
+        AlignedSimpleVector<float> copy = v;
+        assert(is_aligned(copy.Data(), 64) && copy == v);
+        v.ShrinkToFit();
+        assert(is_aligned(v.Data(), 64));
+    }
+    {
+        AlignedSimpleVector<char, 256> bytes(3, 'x');
+        assert(is_aligned(bytes.Data(), 256));
+        // Большой буфер выравнивается по большой странице
+        AlignedSimpleVector<double> huge(kHugePageSize / sizeof(double) + 1, 1.5);
+        assert(is_aligned(huge.Data(), kHugePageSize) && huge[huge.GetSize() - 1] == 1.5);
+        huge.Resize(10);
+        huge.ShrinkToFit();
+        assert(is_aligned(huge.Data(), 64) && huge.GetSize() == 10);
+        static_assert(AlignedAllocator<double>::IsHuge(kHugePageSize));
+        static_assert(!AlignedAllocator<double, 64, std::numeric_limits<size_t>::max()>::IsHuge(kHugePageSize));
+    }
+    {
+        // Аллокатор передаётся вместе с буфером и перепривязывается к другим типам
+        CowSimpleVector<int, AlignedAllocator<int>> shared(100, 7);
+        CowSimpleVector<int, AlignedAllocator<int>> copy = shared;
+        copy[0] = 1;
+        assert(is_aligned(copy.Get().Data(), 64) && shared[0] == 7 && copy[0] == 1);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestBufferPool() {
+    cout << "Test buffer pool" << endl;
+    BufferPool& pool = *BufferPool::Local();
+    pool.Trim();
+    pool.ResetStats();
+    static_assert(BufferPool::BlockSize(1) == 16 && BufferPool::BlockSize(17) == 32 && BufferPool::BlockSize(64) == 64);
+    {
+        // Буфер уничтоженного вектора достаётся следующему вектору того же класса
+        const int* first_data = nullptr;
+        {
+            PooledSimpleVector<int> v(100, 1);
+            first_data = v.Data();
+        }
+        assert(pool.GetStats().misses == 1 && pool.GetStats().recycled == 1 && pool.GetStats().cached_blocks == 1);
+        PooledSimpleVector<int> reused(120, 2);
+        assert(reused.Data() == first_data && pool.GetStats().hits == 1 && pool.GetStats().cached_bytes == 0);
+    }
+    {
+        // Рост возвращает прежние буферы в пул, и повторный рост обходится без кучи
+        uint64_t misses_per_round[2] = {};
+        for (uint64_t& misses : misses_per_round) {
+            const uint64_t before = pool.GetStats().misses;
+            PooledSimpleVector<string> v;
+            for (int i = 0; i < 64; ++i) {
+                v.PushBack(to_string(i));
+            }
+            assert(v[63] == "63");
+            misses = pool.GetStats().misses - before;
+        }
+        assert(misses_per_round[0] > 0 && misses_per_round[1] == 0);
+    }
+    {
+        // Сверх ограничений буферы уходят в кучу
+        pool.SetLimits({1, 1 << 20});
+        assert(pool.GetStats().cached_blocks <= 8);
+        {
+            PooledSimpleVector<char> a(1000), b(1000);
+        }
+        assert(pool.GetStats().released >= 1);
+        pool.SetLimits({4, 0});
+        assert(pool.GetStats().cached_blocks == 0 && pool.GetStats().cached_bytes == 0);
+        pool.SetLimits({});
+        // Крупные буферы не проходят через пул
+        PooledSimpleVector<char> big(kPoolMaxBlockBytes + 1);
+        assert(pool.GetStats().cached_blocks == 0);
+    }
+    {
+        // У каждого потока свой пул, а буфер из чужого потока попадает в пул текущего
+        PooledSimpleVector<int> from_thread;
+        BufferPoolStats thread_stats;
+        thread worker([&] {
+            from_thread = PooledSimpleVector<int>(1000, 3);
+            thread_stats = BufferPool::Local()->GetStats();
+        });
+        worker.join();
+        assert(thread_stats.misses == 1 && thread_stats.hits == 0);
+        const size_t cached = pool.GetStats().cached_blocks;
+        from_thread = PooledSimpleVector<int>();
+        assert(pool.GetStats().cached_blocks == cached + 1);
+    }
+    pool.Trim();
+    cout << "Done!" << endl << endl;
+}
+
+void TestSegmentedVector() {
+    cout << "Test segmented vector" << endl;
+    {
+        SegmentedVector<int> v;
+        v.PushBack(0);
+        const int* first = &v[0];
+        int& ref = v[0];
+        // Рост не перемещает элементы: адреса остаются прежними
+        for (int i = 1; i < 10000; ++i) {
+            v.PushBack(i);
+        }
+        assert(&v[0] == first && ref == 0 && v.GetSize() == 10000 && v.GetCapacity() >= 10000);
+        for (size_t i = 0; i < v.GetSize(); ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        // Итераторы проходят границы сегментов
+        assert(accumulate(v.begin(), v.end(), 0LL) == 9999LL * 10000 / 2);
+        assert(v.end() - v.begin() == 10000 && *(v.begin() + 5000) == 5000 && *(v.end() - 1) == 9999);
+        auto it = v.end();
+        --it;
+        assert(*it == 9999 && it[-9999] == 0);
+        assert(v.Find(4097) - v.begin() == 4097 && v.Count(7) == 1 && !v.Contains(-1));
+
+        v.Erase(v.begin() + 10, v.begin() + 20);
+        v.Insert(v.begin(), -1);
+        assert(v.GetSize() == 9991 && v[0] == -1 && v[11] == 20 && v[9990] == 9999);
+        const SegmentedVector<int> copy = v;
+        assert(copy == v && !(copy < v));
+        v[5000] = 0;
+        assert(copy != v && v < copy);
+
+        v.Resize(17);
+        v.ShrinkToFit();
+        assert(v.GetSize() == 17 && v.GetCapacity() == 16 + 32);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.IsEmpty() && v.GetCapacity() == 0 && v.begin() == v.end());
+    }
+    {
+        SegmentedVector<string> words = {"a", "b"};
+        // Аргумент может ссылаться на элемент вектора даже при росте
+        for (int i = 0; i < 100; ++i) {
+            words.EmplaceBack(words[i]);
+        }
+        assert(words.GetSize() == 102 && words[101] == "b");
+        words.Reserve(1000);
+        const string* middle = &words[50];
+        words.Resize(1000);
+        assert(&words[50] == middle && words[999].empty());
+        SegmentedVector<string> moved = std::move(words);
+        assert(&moved[50] == middle && words.IsEmpty());
+        words = moved;
+        assert(words == moved && &words[50] != middle);
+        try {
+            moved.At(1000);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+        assert(count(moved.cbegin(), moved.cend(), "a"s) == 51);
+    }
+    {
+        // polymorphic_allocator не передаётся при присваивании: каждый вектор
+        // остаётся в своей арене
+        std::pmr::monotonic_buffer_resource first_arena;
+        std::pmr::monotonic_buffer_resource second_arena;
+        using PmrSegmentedVector = SegmentedVector<int, std::pmr::polymorphic_allocator<int>>;
+        PmrSegmentedVector first({1, 2, 3}, &first_arena);
+        PmrSegmentedVector second(100, 7, &second_arena);
+        first = second;
+        assert(first == second && first.GetAllocator().resource() == &first_arena);
+        second = PmrSegmentedVector({4, 5}, &first_arena);
+        assert(second.GetSize() == 2 && second[1] == 5 && second.GetAllocator().resource() == &second_arena);
+        PmrSegmentedVector third(&first_arena);
+        const int* element = &first[0];
+        third = std::move(first);
+        assert(&third[0] == element && first.IsEmpty() && third.GetSize() == 100);
+        third.swap(first);
+        assert(&first[0] == element && third.IsEmpty());
+        static_assert(!std::is_nothrow_move_assignable_v<PmrSegmentedVector>);
+        static_assert(std::is_nothrow_move_assignable_v<SegmentedVector<int>>);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestDevector() {
+    cout << "Test devector" << endl;
+    {
+        Devector<int> d;
+        for (int i = 0; i < 100; ++i) {
+            d.PushBack(i);
+            d.PushFront(-i - 1);
+        }
+        assert(d.GetSize() == 200 && d[0] == -100 && d[99] == -1 && d[100] == 0 && d[199] == 99);
+        // Элементы лежат непрерывно
+        assert(d.Data() + 200 == d.end() && accumulate(d.begin(), d.end(), 0) == -100);
+        assert(d.Find(5) - d.begin() == 105 && d.Count(-1) == 1 && !d.Contains(100));
+
+        d.PopFront();
+        d.PopBack();
+        assert(d.GetSize() == 198 && d[0] == -99 && d[197] == 98);
+
+        // Вставка и удаление у начала сдвигают только начало
+        d.Insert(d.begin() + 1, 7);
+        d.Insert(d.end() - 1, 8);
+        assert(d[0] == -99 && d[1] == 7 && d[2] == -98 && d[198] == 8 && d[199] == 98);
+        d.Erase(d.begin() + 1);
+        d.Erase(d.end() - 2);
+        d.Erase(d.begin(), d.begin() + 99);
+        assert(d.GetSize() == 99 && d[0] == 0 && d[98] == 98);
+        d.Erase(d.begin() + 90, d.end());
+        assert(d.GetSize() == 90 && d[89] == 89);
+
+        const Devector<int> copy = d;
+        assert(copy == d && copy.GetCapacity() == 90 && !(copy < d));
+        d.PushFront(-1);
+        assert(d < copy && d != copy);
+        d.ShrinkToFit();
+        assert(d.GetCapacity() == 91 && d.GetFrontCapacity() == 0 && d[0] == -1);
+        d.ReserveFront(10);
+        assert(d.GetFrontCapacity() == 10 && d.GetBackCapacity() == 0 && d[90] == 89);
+        try {
+            d.At(91);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        // Очередь постоянной длины не растёт: освобождённое в начале место переиспользуется
+        Devector<int> queue;
+        for (int i = 0; i < 10; ++i) {
+            queue.PushBack(i);
+        }
+        for (int i = 10; i < 100000; ++i) {
+            assert(queue[0] == i - 10);
+            queue.PopFront();
+            queue.PushBack(i);
+        }
+        assert(queue.GetSize() == 10 && queue.GetCapacity() <= 32 && queue[9] == 99999);
+
+        // Стек, растущий к началу, получает весь прирост спереди
+        Devector<int> stack;
+        for (int i = 0; i < 1000; ++i) {
+            stack.PushFront(i);
+        }
+        assert(stack[0] == 999 && stack[999] == 0 && stack.GetCapacity() < 2048);
+    }
+    {
+        Devector<string> words = {"a", "b"};
+        // Аргумент может ссылаться на элемент вектора даже при росте и сдвиге
+        for (int i = 0; i < 50; ++i) {
+            words.PushFront(words[words.GetSize() - 1]);
+            words.EmplaceBack(words[0]);
+        }
+        assert(words.GetSize() == 102 && words[0] == "b" && words[101] == "b" && words[50] == "a");
+        words.Emplace(words.begin() + 2, words[50]);
+        words.Emplace(words.end() - 2, words[0]);
+        assert(words.GetSize() == 104 && words[2] == "a" && words[102] == "b");
+        words.Resize(200);
+        assert(words[199].empty() && words[103] == "b");
+        Devector<string> moved = std::move(words);
+        assert(words.IsEmpty() && moved.GetSize() == 200);
+        words = moved;
+        assert(words == moved);
+        words.Erase(words.begin() + 5, words.begin() + 195);
+        assert(words.GetSize() == 10 && words[4] == moved[4] && words[5] == moved[195]);
+        words.Clear();
+        assert(words.IsEmpty() && words.begin() == words.end());
+    }
+    {
+        const list<int> source = {1, 2, 3};
+        const Devector<int> from_list(source.begin(), source.end());
+        assert(from_list.GetSize() == 3 && from_list[2] == 3);
+        const Devector<int> filled(5, 7);
+        assert(filled.Count(7) == 5);
+    }
+    {
+        // Присваивания передают аллокатор по правилам propagate_on_container_*
+        size_t first_bytes = 0;
+        size_t second_bytes = 0;
+        using TrackingDevector = Devector<string, TrackingAllocator<string>>;
+        TrackingDevector first(3, "first"s, TrackingAllocator<string>(1, &first_bytes));
+        TrackingDevector second({"a"s, "b"s}, TrackingAllocator<string>(2, &second_bytes));
+        first = second;
+        assert(first.GetAllocator().id == 2 && first == second);
+        assert(first_bytes == 0 && second_bytes == 4 * sizeof(string));
+        TrackingDevector third(TrackingAllocator<string>(3));
+        third = move(first);
+        assert(third.GetAllocator().id == 2 && third.GetSize() == 2 && first.IsEmpty());
+        static_assert(is_nothrow_move_assignable_v<TrackingDevector>);
+
+        // Аллокатор pmr не передаётся: элементы переносятся в память приёмника
+        std::pmr::monotonic_buffer_resource first_arena;
+        std::pmr::monotonic_buffer_resource second_arena;
+        using PmrDevector = Devector<int, std::pmr::polymorphic_allocator<int>>;
+        PmrDevector source({1, 2, 3}, &first_arena);
+        PmrDevector target(&second_arena);
+        target = source;
+        assert(target.GetAllocator().resource() == &second_arena && target == source);
+        target = move(source);
+        assert(target.GetAllocator().resource() == &second_arena && target.GetSize() == 3);
+        static_assert(!is_nothrow_move_assignable_v<PmrDevector>);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestGapBuffer() {
+    cout << "Test gap buffer" << endl;
+    {
+        const string initial = "hello world";
+        GapBuffer<char> text(initial.begin(), initial.end());
+        string model = initial;
+        // Серия правок у курсора не сдвигает хвост
+        text.MoveCursor(5);
+        for (char c : ", dear"s) {
+            text.Insert(text.GetCursor(), c);
+        }
+        model.insert(5, ", dear");
+        assert(text.GetCursor() == 11 && text.GetTail().GetSize() == 6);
+        text.Erase(10);
+        text.Erase(9);
+        model.erase(9, 2);
+        assert(text.GetSize() == model.size() && text.GetCursor() == 9);
+        for (size_t i = 0; i < model.size(); ++i) {
+            assert(text[i] == model[i]);
+        }
+
+        // Случайные правки сверяются со string
+        size_t cursor = 0;
+        for (size_t step = 0; step < 5000; ++step) {
+            cursor = (cursor * 31 + step * 7) % (model.size() + 1);
+            if (step % 3 == 0 && cursor < model.size()) {
+                const size_t last = min(model.size(), cursor + step % 5);
+                text.Erase(cursor, last);
+                model.erase(cursor, last - cursor);
+            } else {
+                const char c = static_cast<char>('a' + step % 26);
+                text.Insert(cursor, c);
+                model.insert(model.begin() + cursor, c);
+            }
+        }
+        assert(text.GetSize() == model.size() && text.At(model.size() - 1) == model.back());
+        assert(string(text.GetHead().begin(), text.GetHead().end()) + string(text.GetTail().begin(), text.GetTail().end())
+               == model);
+        const SimpleSpan<char> all = text.Compact();
+        assert(string(all.begin(), all.end()) == model && text.GetCursor() == model.size());
+        try {
+            text.At(model.size());
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    {
+        GapBuffer<string> lines = {"a", "b", "c"};
+        // Аргумент может ссылаться на элемент буфера, который переместится
+        lines.Insert(0, lines[2]);
+        lines.Insert(4, lines[0]);
+        lines.PushBack("d");
+        assert(lines.GetSize() == 6 && lines[0] == "c" && lines[4] == "c" && lines[5] == "d");
+        lines.Erase(1, 3);
+        assert(lines.GetSize() == 4 && lines[1] == "c");
+        GapBuffer<string> copy = lines;
+        assert(copy.GetCapacity() == 4 && copy[3] == "d" && copy.GetGapSize() == 0);
+        copy.Insert(2, "x");
+        assert(copy[2] == "x" && copy[4] == "d");
+        GapBuffer<string> moved = std::move(copy);
+        assert(copy.IsEmpty() && moved.GetSize() == 5);
+        moved.Clear();
+        assert(moved.IsEmpty() && moved.GetGapSize() == moved.GetCapacity());
+        moved.Insert(0, lines.GetHead().begin(), lines.GetHead().end());
+        assert(moved.GetSize() == lines.GetCursor());
+    }
+    {
+        // Перемещение между разными аренами переносит элементы, а не буфер
+        std::pmr::monotonic_buffer_resource first_arena;
+        std::pmr::monotonic_buffer_resource second_arena;
+        using PmrGapBuffer = GapBuffer<int, std::pmr::polymorphic_allocator<int>>;
+        PmrGapBuffer first({1, 2, 3, 4}, &first_arena);
+        first.MoveCursor(2);
+        first.Insert(2, 10);
+        PmrGapBuffer second({9}, &second_arena);
+        second = std::move(first);
+        assert(second.GetAllocator().resource() == &second_arena && first.IsEmpty());
+        assert(second.GetSize() == 5 && second[2] == 10 && second[4] == 4);
+        PmrGapBuffer third(&second_arena);
+        third = std::move(second);
+        assert(third.GetSize() == 5 && third[0] == 1 && second.IsEmpty());
+        static_assert(!std::is_nothrow_move_assignable_v<PmrGapBuffer>);
+        static_assert(std::is_nothrow_move_assignable_v<GapBuffer<int>>);
+    }
+    cout << "Done!" << endl << endl;
+}
+
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+// Строит таблицу квадратов в SimpleVector и переносит её в StaticVector при компиляции
+constexpr StaticVector<int, 16> MakeSquares() {
+    SimpleVector<int> squares;
+    for (int i = 0; i < 10; ++i) {
+        squares.PushBack(i * i);
+    }
+    SimpleVector<int> copy = squares;
+    copy.Resize(12);
+    copy.Reserve(100);
+    StaticVector<int, 16> table;
+    for (size_t i = 0; i < copy.GetSize(); ++i) {
+        table.PushBack(copy[i]);
+    }
+    return table;
+}
+#endif
+
+void TestStaticVector() {
+    cout << "Test static vector" << endl;
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+    {
+        constexpr StaticVector<int, 16> kSquares = MakeSquares();
+        static_assert(kSquares.GetSize() == 12 && kSquares[9] == 81 && kSquares[11] == 0);
+        constexpr StaticVector<int, 4> kPrimes = [] {
+            StaticVector<int, 4> primes = {2, 3, 7};
+            primes.Insert(primes.begin() + 2, 5);
+            return primes;
+        }();
+        static_assert(kPrimes.IsFull() && kPrimes[2] == 5 && kPrimes[3] == 7);
+        static_assert(Reserve(5).value == 5);
+        assert(kSquares[3] == 9 && kPrimes.At(0) == 2);
+    }
+#endif
+    {
+        StaticVector<int, 8> v = {1, 2, 3};
+        static_assert(StaticVector<int, 8>::GetCapacity() == 8 && sizeof(v) == 8 * sizeof(int) + sizeof(size_t));
+        v.PushBack(4);
+        v.Insert(v.begin(), 0);
+        v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(v.GetSize() == 3 && v[0] == 0 && v[1] == 3 && v[2] == 4);
+        const StaticVector<int, 8> copy = v;
+        assert(copy == v && !(copy < v));
+        v.Resize(8);
+        assert(v.IsFull() && v[7] == 0 && copy < v);
+        try {
+            v.PushBack(9);
+            assert(false);
+        } catch (const length_error&) {
+        }
+        assert(v.GetSize() == 8);
+    }
+    {
+        StaticVector<string, 4> words(2, "a"s);
+        // Аргумент может ссылаться на элемент вектора
+        words.Insert(words.begin(), words[1]);
+        words.EmplaceBack(3, 'b');
+        assert(words.IsFull() && words[0] == "a" && words[3] == "bbb");
+        StaticVector<string, 4> other = {"x"};
+        other = words;
+        assert(other == words);
+        StaticVector<string, 4> moved = std::move(other);
+        assert(moved.GetSize() == 4 && moved[3] == "bbb");
+        moved = StaticVector<string, 4>{"y"};
+        assert(moved.GetSize() == 1 && moved[0] == "y");
+        words.Erase(words.begin());
+        words.PopBack();
+        assert(words.GetSize() == 2 && words[1] == "a");
+        try {
+            words.At(2);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+    }
+    cout << "Done!" << endl << endl;
+}
+
+void TestFlatContainers() {
+    cout << "Test flat containers" << endl;
+    {
+        FlatSet<int> set = {5, 1, 3, 5, 1};
+        assert(set.GetSize() == 3 && *set.begin() == 1 && set.Contains(5) && !set.Contains(2));
+        assert(set.Insert(2).second && !set.Insert(3).second && set.GetSize() == 4);
+        const vector<int> more = {9, 0, 4, 2, 9};
+        set.Insert(more.begin(), more.end());
+        const vector<int> expected = {0, 1, 2, 3, 4, 5, 9};
+        assert(equal(set.begin(), set.end(), expected.begin(), expected.end()));
+        assert(*set.LowerBound(6) == 9 && *set.UpperBound(4) == 5 && set.Find(7) == set.end());
+        assert(set.Erase(3) == 1 && set.Erase(3) == 0 && set.Count(3) == 0);
+        SimpleVector<int> keys = set.Extract();
+        assert(keys.GetSize() == 6 && keys[5] == 9 && set.IsEmpty());
+
+        // Раскладка Эйтцингера находит то же, что и двоичный поиск, для всех размеров
+        for (int n = 0; n < 70; ++n) {
+            SimpleVector<int> evens;
+            for (int i = 0; i < n; ++i) {
+                evens.PushBack(2 * (n - i));
+            }
+            const FlatSet<int> sorted(evens);
+            const FlatSet<int, std::less<int>, EytzingerLayout> eytzinger(std::move(evens));
+            assert(sorted.GetSize() == static_cast<size_t>(n) && eytzinger.GetSize() == sorted.GetSize());
+            for (int key = -1; key <= 2 * n + 2; ++key) {
+                assert(sorted.LowerBound(key) - sorted.begin() == lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+                assert(eytzinger.LowerBound(key) - eytzinger.begin() == sorted.LowerBound(key) - sorted.begin());
+                assert(eytzinger.Contains(key) == (key > 0 && key <= 2 * n && key % 2 == 0));
+            }
+        }
+    }
+    {
+        // Строки сравниваются по убыванию, при повторе остаётся первый ключ
+        FlatSet<string, greater<string>, EytzingerLayout> words = {"b", "c", "a"};
+        words.Insert({"d", "a"});
+        assert(words.GetSize() == 4 && *words.begin() == "d" && words.Contains("a"));
+        words.Erase(words.begin());
+        assert(*words.begin() == "c" && !words.Contains("d"));
+        words.Clear();
+        assert(words.IsEmpty() && !words.Contains("a"));
+    }
+    {
+        FlatMap<int, string> map = {{2, "two"}, {1, "one"}, {2, "second two"}};
+        assert(map.GetSize() == 2 && map.At(2) == "two" && *map.Find(1) == "one" && map.Find(3) == nullptr);
+        map[3] = "three";
+        assert(map.Insert(0, "zero").second && !map.Insert(0, "nil").second && map.At(0) == "zero");
+        map.InsertOrAssign(0, "nil"s);
+        const vector<pair<int, string>> pairs = {{5, "five"}, {4, "four"}, {1, "uno"}};
+        map.Insert(pairs.begin(), pairs.end());
+        assert(map.GetSize() == 6 && map.At(0) == "nil" && map.At(1) == "one" && map.GetKeys()[5] == 5);
+        assert(map.GetValues()[4] == "four");
+        string joined;
+        map.ForEach([&joined](int key, const string& value) {
+            joined += to_string(key) + value;
+        });
+        assert(joined == "0nil1one2two3three4four5five");
+        assert(map.Erase(3) == 1 && !map.Contains(3) && map.Count(4) == 1);
+        try {
+            map.At(3);
+            assert(false);
+        } catch (const out_of_range&) {
+        }
+
+        // Новые пары вперемешку со старыми: повторы внутри диапазона и совпадения
+        // с имеющимися ключами отбрасываются, столбцы остаются согласованными
+        FlatMap<int, int> merged;
+        for (int i = 0; i < 10; ++i) {
+            merged.Emplace(i * 10, i);
+        }
+        const std::map<int, int> extra = {{5, -5}, {10, -10}, {95, -95}, {-1, 1}};
+        merged.Insert(extra.begin(), extra.end());
+        const vector<pair<int, int>> repeated = {{42, 1}, {42, 2}, {7, 7}};
+        merged.Insert(repeated.begin(), repeated.end());
+        assert(merged.GetSize() == 15 && merged.At(10) == 1 && merged.At(42) == 1 && merged.At(-1) == 1);
+        assert(is_sorted(merged.GetKeys().begin(), merged.GetKeys().end()));
+        merged.ForEach([](int key, int value) {
+            assert(key == value * 10 || key == -value || key == 42 || key == 7);
+        });
+
+        FlatMap<int, int, std::less<int>, EytzingerLayout> squares;
+        for (int i = 100; i > 0; --i) {
+            squares.Emplace(i, i * i);
+        }
+        assert(squares.GetSize() == 100 && squares.At(7) == 49 && squares.GetKeys()[0] == 1);
+        const auto copy = squares;
+        assert(copy == squares);
+        ++squares[7];
+        assert(copy != squares);
+    }
+    {
+        // Ключи, значения и индекс берут память из одного ресурса
+        alignas(std::max_align_t) char arena[16384];
+        std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+        using PmrFlatMap = FlatMap<int, std::pmr::string, std::less<int>, EytzingerLayout,
+                                   std::pmr::polymorphic_allocator<int>>;
+        PmrFlatMap names(&resource);
+        const vector<pair<int, const char*>> pairs = {{3, "a rather long third value"}, {1, "a rather long first value"}};
+        names.Insert(pairs.begin(), pairs.end());
+        names.Emplace(2, "a rather long second value");
+        assert(names.GetSize() == 3 && names.At(2) == "a rather long second value");
+        assert(names.GetAllocator().resource() == &resource);
+        assert(names.GetValues()[0].get_allocator().resource() == &resource);
+        assert(names.Erase(1) == 1 && names.GetKeys()[0] == 2);
+    }
+    {
+        // Перестройка индекса бросает исключение: поиск переходит на двоичный
+        // и не выходит за границы ключей
+        struct ByValue {
+            bool operator()(const ThrowingAssignObj& lhs, const ThrowingAssignObj& rhs) const {
+                return lhs.value < rhs.value;
+            }
+        };
+        FlatSet<ThrowingAssignObj, ByValue, EytzingerLayout> set;
+        for (int i = 0; i < 5; ++i) {
+            set.Insert(ThrowingAssignObj(i));
+        }
+        ThrowingAssignObj::throw_on_assign = true;
+        try {
+            set.Erase(set.begin() + 4);
+            assert(false);
+        } catch (const runtime_error&) {
+        }
+        ThrowingAssignObj::throw_on_assign = false;
+        assert(set.GetSize() == 4 && set.Contains(ThrowingAssignObj(3)) && !set.Contains(ThrowingAssignObj(4)));
+        assert(set.LowerBound(ThrowingAssignObj(10)) == set.end());
+        set.Insert(ThrowingAssignObj(7));
+        assert(set.Contains(ThrowingAssignObj(7)) && set.GetKeys()[4].value == 7);
+    }
+    assert(ThrowingAssignObj::alive == 0);
+    cout << "Done!" << endl << endl;
+}
+
+void TestBitVector() {
+    {
+        BitVector bits;
+        assert(bits.IsEmpty() && bits.None() && bits.FindFirstSet() == 0);
+        for (size_t i = 0; i < 200; ++i) {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.GetSize() == 200 && bits.GetWords().GetSize() == 4);
+        assert(bits.Count() == 67);
+        assert(bits[0] && !bits[1] && bits[198] && !bits[199]);
+        bits[1] = true;
+        bits[0] = bits[2];
+        bits[5].Flip();
+        assert(!bits[0] && bits[1] && !bits[2] && bits[5]);
+        assert(bits.FindFirstSet() == 1 && bits.FindNextSet(2) == 3 && bits.FindNextSet(199) == 200);
+        try {
+            bits.At(200);
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        bits.PopBack();
+        bits.PopBack();
+        assert(bits.GetSize() == 198 && bits.Count() == 67);
+        while (bits.GetSize() > 128) {
+            bits.PopBack();
+        }
+        assert(bits.GetWords().GetSize() == 2);
+    }
+    {
+        // Хвостовые биты остаются нулевыми после Resize, Fill и Flip
+        BitVector bits(70, true);
+        assert(bits.Count() == 70 && bits.GetWords()[1] == 0x3F);
+        bits.Resize(3);
+        assert(bits.Count() == 3 && bits.GetWords().GetSize() == 1);
+        bits.Resize(130, true);
+        assert(bits.Count() == 130);
+        bits.Fill(false);
+        assert(bits.None());
+        bits.Fill(60, 129, true);
+        assert(bits.Count() == 69 && bits.FindFirstSet() == 60 && !bits[129]);
+        bits.Fill(62, 63, false);
+        assert(bits.Count() == 68 && !bits[62] && bits[63]);
+        bits.Flip();
+        assert(bits.Count() == 62 && bits.GetWords()[2] == 0x2);
+        bits.Resize(1000);
+        assert(bits.Count() == 62 && bits.FindNextSet(131) == 1000);
+    }
+    {
+        BitVector lhs(300);
+        BitVector rhs(300);
+        for (size_t i = 0; i < 300; ++i) {
+            lhs[i] = i % 2 == 0;
+            rhs[i] = i % 3 == 0;
+        }
+        assert((lhs & rhs).Count() == 50);
+        assert((lhs | rhs).Count() == 200);
+        assert((lhs ^ rhs).Count() == 150);
+        BitVector diff = lhs;
+        diff.AndNot(rhs);
+        assert(diff.Count() == 100 && !diff[0] && diff[2] && !diff[6]);
+
+        size_t visited = 0;
+        (lhs & rhs).ForEachSet([&visited](size_t index) {
+            assert(index == visited * 6);
+            ++visited;
+        });
+        assert(visited == 50);
+
+        BitVector copy = lhs;
+        assert(copy == lhs && copy != rhs);
+        copy ^= lhs;
+        assert(copy.None() && copy == BitVector(300));
+        assert((BitVector{true, false, true}) != (BitVector{true, false}));
+    }
+    {
+        // Большие вектора проходят через векторные ядра целиком
+        BitVector bits(100000);
+        bits.Fill(true);
+        BitVector mask(100000);
+        mask.Fill(1000, 99000, true);
+        bits &= mask;
+        assert(bits.Count() == 98000 && bits.FindFirstSet() == 1000);
+        bits.Reserve(1 << 20);
+        assert(bits.GetCapacity() >= (1 << 20) && bits.Count() == 98000);
+    }
+}
+
+void TestAssignmentReuse() {
+    {
+        // Копирующее присваивание не выделяет память, если вместимости хватает
+        SimpleVector<string> target(10, "old"s);
+        target.Reserve(32);
+        const string* data = target.Data();
+        SimpleVector<string> shorter(5, "short"s);
+        target = shorter;
+        assert(target == shorter && target.Data() == data && target.GetCapacity() == 32);
+        SimpleVector<string> longer(20, "long"s);
+        target = longer;
+        assert(target == longer && target.Data() == data && target.GetCapacity() == 32);
+        SimpleVector<string> huge(64, "huge"s);
+        target = huge;
+        assert(target == huge && target.GetCapacity() == 64);
+
+        const SimpleVector<string>& self = target;
+        target = self;
+        assert(target == huge);
+        SimpleVector<string>& alias = target;
+        target = move(alias);
+        assert(target == huge);
+    }
+    {
+        // Лишние элементы разрушаются, недостающие конструируются
+        SimpleVector<CountedObj> target;
+        target.Reserve(8);
+        for (int i = 0; i < 6; ++i) {
+            target.EmplaceBack(i);
+        }
+        SimpleVector<CountedObj> source;
+        source.EmplaceBack(10);
+        source.EmplaceBack(11);
+        target = source;
+        assert(CountedObj::alive == 4 && target.GetSize() == 2 && target[1].GetValue() == 11);
+        for (int i = 0; i < 5; ++i) {
+            source.EmplaceBack(i);
+        }
+        target = source;
+        assert(CountedObj::alive == 14 && target.GetSize() == 7 && target[6].GetValue() == 4);
+        assert(target.GetCapacity() == 8);
+    }
+    assert(CountedObj::alive == 0);
+    {
+        // Тривиальные элементы копируются в имеющийся буфер
+        SimpleVector<int> target(100, 7);
+        const int* data = target.Data();
+        SimpleVector<int> source = GenerateVector(50);
+        target = source;
+        assert(target == source && target.Data() == data);
+    }
+    {
+        static_assert(std::is_nothrow_move_constructible_v<SimpleVector<string>>);
+        static_assert(std::is_nothrow_move_assignable_v<SimpleVector<string>>);
+        static_assert(!std::is_nothrow_move_assignable_v<PmrSimpleVector<int>>);
+
+        // std::vector перемещает вложенные векторы при росте: буферы остаются на месте
+        std::vector<SimpleVector<int>> vectors;
+        vectors.push_back(GenerateVector(10));
+        const int* data = vectors[0].Data();
+        for (int i = 0; i < 100; ++i) {
+            vectors.push_back(GenerateVector(1));
+        }
+        assert(vectors[0].Data() == data && vectors[0].GetSize() == 10);
+    }
+}
+
+// Бросает исключение вместо аварийного завершения, чтобы тест мог поймать проваленную проверку
+[[noreturn]] void ThrowCheckFailure(const char* message) {
+    throw std::logic_error(message);
+}
+
+template <typename Fn>
+bool CheckFails(Fn fn) {
+    try {
+        fn();
+    } catch (const std::logic_error&) {
+        return true;
+    }
+    return false;
+}
+
+void TestCheckedMode() {
+    cout << "Test checked mode" << endl;
+    if constexpr (kVectorChecked) {
+        const CheckFailureHandler previous = SetCheckFailureHandler(ThrowCheckFailure);
+        SimpleVector<int> v = {1, 2, 3};
+        SimpleVector<int> other = {4, 5};
+        assert(CheckFails([&] { return v[3]; }));
+        assert(CheckFails([&] { return *v.end(); }));
+        assert(CheckFails([&] { v.Erase(v.end()); }));
+        assert(CheckFails([&] { v.Insert(other.begin(), 7); }));
+        assert(CheckFails([&] { v.Erase(v.begin() + 2, v.begin() + 1); }));
+
+        // Итератор устаревает при перевыделении буфера, но не при вставке без роста
+        auto it = v.begin();
+        v.Reserve(v.GetCapacity() + 1);
+        assert(CheckFails([&] { return *it; }));
+        assert(CheckFails([&] { v.Insert(it, 0); }));
+        it = v.begin() + 1;
+        v.Insert(v.begin(), 0);
+        assert(*it == 1 && v.GetSize() == 4);
+
+        SimpleVector<int> moved = std::move(v);
+        assert(CheckFails([&] { return *it; }));
+        assert(EraseIf(moved, [](int value) { return value % 2 == 0; }) == 2 && moved == SimpleVector<int>({1, 3}));
+        SetCheckFailureHandler(previous);
+    } else {
+        // Без проверок итераторы остаются указателями
+        assert((std::is_same_v<decltype(std::declval<SimpleVector<int>&>().begin()), int*>));
+        assert((noexcept(std::declval<SimpleVector<int>&>()[0])));
+        assert((sizeof(SimpleVector<int>) == sizeof(RawMemory<int>) + 2 * sizeof(size_t)));
+    }
+    cout << "Done!" << endl << endl;
+}
+
 int main() {
     TestTemporaryObjConstructor();
     TestTemporaryObjOperator();
@@ -158,6 +2217,35 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestUninitializedStorage();
+    TestEmplace();
+    TestTrivialRelocation();
+    TestReallocGrowth();
+    TestAllocators();
+    TestSmallVector();
+    TestGrowthPolicies();
+    TestShrinkAndResize();
+    TestBulkInsert();
+    TestBulkErase();
+    TestStats();
+    TestSimd();
+    TestParallel();
+    TestConcurrentVector();
+    TestMappedVector();
+    TestSerialization();
+    TestSpan();
+    TestCowVector();
+    TestSoaVector();
+    TestAlignedAllocator();
+    TestBufferPool();
+    TestSegmentedVector();
+    TestDevector();
+    TestGapBuffer();
+    TestStaticVector();
+    TestFlatContainers();
+    TestBitVector();
+    TestAssignmentReuse();
+    TestCheckedMode();
 
 
     SimpleVector<string> kek = {"kek"s, "lol"s};
@@ -0,0 +1,460 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "growth_policy.h"
+
+// Вектор тривиально копируемых записей, который хранится в файле, отображённом в память.
+// Открытие файла не читает и не копирует данные: страницы подгружаются ядром по мере
+// обращения, а несколько процессов, открывших файл только для чтения, делят одни и те же
+// страницы кэша. Изменения попадают в файл без явной записи, Flush лишь дожидается их
+// сброса на диск. Требует POSIX; рост на месте через mremap доступен только в Linux
+
+enum class MappedMode {
+    // Отображение только для чтения. Файл должен существовать
+    kReadOnly,
+    // Отображение для чтения и записи. Отсутствующий или пустой файл создаётся
+    kReadWrite,
+};
+
+// Владеет открытым файлом и его отображением в память. Как и RawMemory, не знает
+// о типе хранимых данных, а только выделяет и изменяет область памяти
+class MappedMemory {
+public:
+    MappedMemory() = default;
+
+    // Открывает файл path и отображает его целиком. Бросает std::system_error
+    MappedMemory(const std::string& path, MappedMode mode)
+            : writable_(mode == MappedMode::kReadWrite) {
+        fd_ = ::open(path.c_str(), writable_ ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open " + path);
+        }
+        struct stat info = {};
+        if (::fstat(fd_, &info) != 0) {
+            const int error = errno;
+            ::close(fd_);
+            ThrowSystemError("fstat " + path, error);
+        }
+        try {
+            Map(static_cast<size_t>(info.st_size));
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedMemory(const MappedMemory&) = delete;
+    MappedMemory& operator=(const MappedMemory&) = delete;
+
+    MappedMemory(MappedMemory&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1))
+            , data_(std::exchange(other.data_, nullptr))
+            , length_(std::exchange(other.length_, 0))
+            , writable_(other.writable_) {
+    }
+
+    MappedMemory& operator=(MappedMemory&& other) noexcept {
+        if (this != &other) {
+            Close();
+            fd_ = std::exchange(other.fd_, -1);
+            data_ = std::exchange(other.data_, nullptr);
+            length_ = std::exchange(other.length_, 0);
+            writable_ = other.writable_;
+        }
+        return *this;
+    }
+
+    ~MappedMemory() {
+        Close();
+    }
+
+    // Возвращает адрес начала отображения или nullptr для пустого файла
+    std::byte* Get() const noexcept {
+        return data_;
+    }
+
+    // Возвращает длину файла и отображения в байтах
+    size_t Length() const noexcept {
+        return length_;
+    }
+
+    bool IsWritable() const noexcept {
+        return writable_;
+    }
+
+    // Изменяет длину файла и отображения, сохраняя общее содержимое. Новые байты нулевые.
+    // Отображение может переместиться, поэтому прежние указатели в него становятся недействительными.
+    // Отображение никогда не выходит за конец файла: при росте сначала удлиняется файл,
+    // а при уменьшении сначала сжимается отображение
+    void Resize(size_t length) {
+        assert(writable_);
+        const bool grows = length > length_;
+        if (grows) {
+            Truncate(length);
+        }
+        Remap(length);
+        if (!grows) {
+            Truncate(length);
+        }
+    }
+
+    // Дожидается записи изменённых страниц на диск
+    void Sync() const {
+        if (data_ != nullptr && ::msync(data_, length_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+private:
+    int fd_ = -1;
+    std::byte* data_ = nullptr;
+    size_t length_ = 0;
+    bool writable_ = false;
+
+    [[noreturn]] static void ThrowSystemError(const std::string& what, int error = errno) {
+        throw std::system_error(error, std::generic_category(), what);
+    }
+
+    void Map(size_t length) {
+        if (length != 0) {
+            const int protection = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+            void* data = ::mmap(nullptr, length, protection, MAP_SHARED, fd_, 0);
+            if (data == MAP_FAILED) {
+                ThrowSystemError("mmap");
+            }
+            data_ = static_cast<std::byte*>(data);
+        }
+        length_ = length;
+    }
+
+    void Truncate(size_t length) {
+        if (::ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+    }
+
+    // Отображает length байт файла на месте прежнего отображения или рядом с ним
+    void Remap(size_t length) {
+        if (data_ == nullptr || length == 0) {
+            Unmap();
+            Map(length);
+            return;
+        }
+#ifdef __linux__
+        void* data = ::mremap(data_, length_, length, MREMAP_MAYMOVE);
+        if (data == MAP_FAILED) {
+            ThrowSystemError("mremap");
+        }
+        data_ = static_cast<std::byte*>(data);
+        length_ = length;
+#else
+        // Новое отображение создаётся раньше, чем снимается старое: если mmap не удастся,
+        // прежнее отображение останется в силе
+        std::byte* old_data = data_;
+        const size_t old_length = length_;
+        Map(length);
+        ::munmap(old_data, old_length);
+#endif
+    }
+
+    void Unmap() noexcept {
+        if (data_ != nullptr) {
+            ::munmap(data_, length_);
+            data_ = nullptr;
+        }
+        length_ = 0;
+    }
+
+    void Close() noexcept {
+        Unmap();
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+};
+
+// Заголовок в начале файла. Поля хранятся в порядке байтов машины, создавшей файл
+struct MappedVectorHeader {
+    static constexpr uint64_t kMagic = 0x3176535065766F4DULL;
+    static constexpr uint32_t kVersion = 1;
+
+    uint64_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t element_size = 0;
+    // Число элементов
+    uint64_t size = 0;
+    // Смещение первого элемента от начала файла
+    uint64_t data_offset = 0;
+};
+
+// Вектор записей типа Type в отображённом файле. Интерфейс повторяет SimpleVector,
+// но вместимость — это место в файле после заголовка, а рост удлиняет файл.
+// Insert и Erase сдвигают хвост одним memmove.
+// В режиме kReadOnly изменяющие функции вызывать нельзя
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector stores raw bytes of its elements");
+
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+public:
+
+    // Смещение элементов от начала файла: заголовок дополняется до строки кэша
+    static constexpr size_t kDataOffset = std::max<size_t>(64, alignof(Type));
+    static_assert(sizeof(MappedVectorHeader) <= kDataOffset);
+
+    // Создаёт пустой вектор без файла. Его можно только заменить перемещением
+    MappedSimpleVector() = default;
+
+    // Открывает вектор из файла path. Бросает std::system_error, если файл не удалось
+    // открыть, и std::runtime_error, если его заголовок не подходит для Type
+    explicit MappedSimpleVector(const std::string& path, MappedMode mode = MappedMode::kReadWrite)
+            : memory_(path, mode) {
+        if (memory_.Length() == 0 && memory_.IsWritable()) {
+            memory_.Resize(kDataOffset);
+            MappedVectorHeader header;
+            header.element_size = sizeof(Type);
+            header.data_offset = kDataOffset;
+            std::memcpy(memory_.Get(), &header, sizeof(header));
+        }
+        Validate();
+    }
+
+    size_t GetSize() const noexcept {
+        return memory_.Get() == nullptr ? 0 : Header()->size;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return memory_.Length() <= kDataOffset ? 0 : (memory_.Length() - kDataOffset) / sizeof(Type);
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    bool IsReadOnly() const noexcept {
+        return !memory_.IsWritable();
+    }
+
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return begin()[index];
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return begin()[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index или бросает std::out_of_range
+    Type& At(size_t index) {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return begin()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) {
+            throw std::out_of_range("Index out of range");
+        }
+        return begin()[index];
+    }
+
+    void Clear() noexcept {
+        SetSize(0);
+    }
+
+    // Изменяет размер. Новые элементы инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size > GetCapacity()) {
+            Reserve(GrowthPolicy::NextCapacity(GetCapacity(), new_size, sizeof(Type)));
+        }
+        std::uninitialized_value_construct(begin() + std::min(new_size, GetSize()), begin() + new_size);
+        SetSize(new_size);
+    }
+
+    // Удлиняет файл под new_capacity элементов. Итераторы становятся недействительными.
+    // Бросает std::bad_array_new_length, если длина файла не помещается в size_t или off_t
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            memory_.Resize(FileLength(new_capacity));
+        }
+    }
+
+    // Укорачивает файл до размера вектора
+    void ShrinkToFit() {
+        if (GetCapacity() > GetSize()) {
+            memory_.Resize(FileLength(GetSize()));
+        }
+    }
+
+    void PushBack(const Type& item) {
+        const size_t size = GetSize();
+        if (size == GetCapacity()) {
+            // item может лежать в отображении, которое переместится при росте
+            const Type copy = item;
+            Reserve(GrowthPolicy::NextCapacity(GetCapacity(), size + 1, sizeof(Type)));
+            begin()[size] = copy;
+        } else {
+            begin()[size] = item;
+        }
+        SetSize(size + 1);
+    }
+
+    // Конструирует элемент в конце и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return *Emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    void PopBack() noexcept {
+        if (!IsEmpty()) {
+            SetSize(GetSize() - 1);
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& item) {
+        return Emplace(pos, item);
+    }
+
+    // Конструирует элемент перед pos и возвращает итератор на него. Хвост сдвигается memmove.
+    // args могут ссылаться на элементы вектора: элемент создаётся до роста и сдвига
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = static_cast<size_t>(pos - cbegin());
+        const size_t size = GetSize();
+        assert(offset <= size);
+        const Type item = MakeItem(std::forward<Args>(args)...);
+        if (size == GetCapacity()) {
+            Reserve(GrowthPolicy::NextCapacity(GetCapacity(), size + 1, sizeof(Type)));
+        }
+        Type* data = Data();
+        std::memmove(static_cast<void*>(data + offset + 1), data + offset, (size - offset) * sizeof(Type));
+        data[offset] = item;
+        SetSize(size + 1);
+        return data + offset;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        assert(pos != cend());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая хвост memmove
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t offset = static_cast<size_t>(first - cbegin());
+        const size_t last_offset = static_cast<size_t>(last - cbegin());
+        const size_t size = GetSize();
+        assert(offset <= last_offset && last_offset <= size);
+        Type* data = Data();
+        std::memmove(static_cast<void*>(data + offset), data + last_offset, (size - last_offset) * sizeof(Type));
+        SetSize(size - (last_offset - offset));
+        return data + offset;
+    }
+
+    // Дожидается записи изменений на диск
+    void Flush() const {
+        memory_.Sync();
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator cend() const noexcept {
+        return Data() + GetSize();
+    }
+
+private:
+
+    MappedMemory memory_;
+
+    MappedVectorHeader* Header() const noexcept {
+        return reinterpret_cast<MappedVectorHeader*>(memory_.Get());
+    }
+
+    Type* Data() const noexcept {
+        return memory_.Get() == nullptr ? nullptr : reinterpret_cast<Type*>(memory_.Get() + kDataOffset);
+    }
+
+    // Длина файла под capacity элементов. Она должна помещаться и в size_t, и в off_t
+    static size_t FileLength(size_t capacity) {
+        constexpr size_t kMaxLength = std::min<uintmax_t>(std::numeric_limits<size_t>::max(),
+                                                          std::numeric_limits<off_t>::max());
+        if (capacity > (kMaxLength - kDataOffset) / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return kDataOffset + capacity * sizeof(Type);
+    }
+
+    // Агрегаты вроде записей с открытыми полями конструируются фигурными скобками
+    template <typename... Args>
+    static Type MakeItem(Args&&... args) {
+        if constexpr (std::is_constructible_v<Type, Args&&...>) {
+            return Type(std::forward<Args>(args)...);
+        } else {
+            return Type{std::forward<Args>(args)...};
+        }
+    }
+
+    void SetSize(size_t size) noexcept {
+        assert(!IsReadOnly());
+        if (memory_.Get() != nullptr) {
+            Header()->size = size;
+        }
+    }
+
+    void Validate() const {
+        if (memory_.Length() < kDataOffset) {
+            throw std::runtime_error("Mapped vector file is too short for its header");
+        }
+        const MappedVectorHeader* header = Header();
+        if (header->magic != MappedVectorHeader::kMagic || header->version != MappedVectorHeader::kVersion) {
+            throw std::runtime_error("Mapped vector file has an unknown format");
+        }
+        if (header->element_size != sizeof(Type) || header->data_offset != kDataOffset) {
+            throw std::runtime_error("Mapped vector file holds elements of a different type");
+        }
+        if (header->size > GetCapacity()) {
+            throw std::runtime_error("Mapped vector file is truncated");
+        }
+    }
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Параллельные алгоритмы над непрерывными контейнерами (SimpleVector, SmallVector).
+// Диапазон делится на равные части по числу потоков GetParallelConcurrency(), каждая часть
+// обрабатывается в своём std::thread, первую выполняет вызывающий поток.
+// Диапазоны короче двух порогов threshold обрабатываются последовательно.
+// Сборка требует поддержки потоков (-pthread)
+
+// Порог по умолчанию для Parallel* алгоритмов, в элементах
+inline constexpr size_t kParallelThreshold = size_t(1) << 16;
+
+// Объём в байтах, начиная с которого SimpleVector заполняет и копирует буфер параллельно.
+// Можно переопределить до подключения заголовков; SIZE_MAX отключает параллельное заполнение
+#ifndef SIMPLE_VECTOR_PARALLEL_CONSTRUCT_BYTES
+#define SIMPLE_VECTOR_PARALLEL_CONSTRUCT_BYTES (size_t(1) << 22)
+#endif
+
+inline constexpr size_t kParallelConstructBytes = SIMPLE_VECTOR_PARALLEL_CONSTRUCT_BYTES;
+
+inline std::atomic<size_t>& ParallelConcurrencySetting() noexcept {
+    static std::atomic<size_t> threads{0};
+    return threads;
+}
+
+// Ограничивает число потоков, между которыми делится работа. 0 — по числу аппаратных потоков
+inline void SetParallelConcurrency(size_t threads) noexcept {
+    ParallelConcurrencySetting().store(threads, std::memory_order_relaxed);
+}
+
+inline size_t GetParallelConcurrency() noexcept {
+    const size_t threads = ParallelConcurrencySetting().load(std::memory_order_relaxed);
+    return threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Возвращает число частей, на которые делится диапазон из n элементов:
+// не больше GetParallelConcurrency() и так, чтобы в каждой части было не меньше threshold элементов
+inline size_t ParallelChunkCount(size_t n, size_t threshold) noexcept {
+    threshold = std::max(threshold, size_t(1));
+    if (n < 2 * threshold) {
+        return 1;
+    }
+    return std::min(GetParallelConcurrency(), n / threshold);
+}
+
+// Возвращает индекс начала части chunk при делении n элементов на chunks частей
+inline size_t ParallelChunkBegin(size_t n, size_t chunks, size_t chunk) noexcept {
+    return n / chunks * chunk + std::min(chunk, n % chunks);
+}
+
+// Вызывает task(i) для каждого i из [0, tasks), по потоку на задачу.
+// Если поток не удалось создать, оставшиеся задачи выполняются в вызывающем потоке.
+// Первое исключение из task пробрасывается после завершения всех задач
+template <typename Task>
+void ParallelInvoke(size_t tasks, Task&& task) {
+    std::vector<std::exception_ptr> errors(tasks);
+    auto run = [&](size_t index) {
+        try {
+            task(index);
+        } catch (...) {
+            errors[index] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(tasks);
+    size_t started = 1;
+    try {
+        for (; started < tasks; ++started) {
+            threads.emplace_back(run, started);
+        }
+    } catch (const std::system_error&) {
+    }
+    if (tasks != 0) {
+        run(0);
+    }
+    for (size_t index = started; index < tasks; ++index) {
+        run(index);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Делит [0, n) на части и вызывает fn(begin, end) для каждой из них параллельно
+template <typename Fn>
+void ParallelFor(size_t n, size_t threshold, Fn&& fn) {
+    const size_t chunks = ParallelChunkCount(n, threshold);
+    if (chunks == 1) {
+        if (n != 0) {
+            fn(size_t(0), n);
+        }
+        return;
+    }
+    ParallelInvoke(chunks, [&](size_t chunk) {
+        fn(ParallelChunkBegin(n, chunks, chunk), ParallelChunkBegin(n, chunks, chunk + 1));
+    });
+}
+
+// Присваивает value всем элементам вектора
+template <typename Vector, typename Type>
+void ParallelFill(Vector& vector, const Type& value, size_t threshold = kParallelThreshold) {
+    auto first = vector.begin();
+    ParallelFor(vector.GetSize(), threshold, [&](size_t begin, size_t end) {
+        std::fill(first + begin, first + end, value);
+    });
+}
+
+// Записывает в output[i] результат op(input[i]). Размеры векторов должны совпадать.
+// input и output могут быть одним и тем же вектором
+template <typename InputVector, typename OutputVector, typename UnaryOp>
+void ParallelTransform(const InputVector& input, OutputVector& output, UnaryOp op,
+                       size_t threshold = kParallelThreshold) {
+    assert(input.GetSize() == output.GetSize());
+    auto from = input.begin();
+    auto to = output.begin();
+    ParallelFor(input.GetSize(), threshold, [&](size_t begin, size_t end) {
+        std::transform(from + begin, from + end, to + begin, op);
+    });
+}
+
+// Сортирует вектор: части сортируются параллельно, затем попарно сливаются,
+// причём слияния одного уровня тоже выполняются параллельно. Сортировка неустойчива
+template <typename Vector, typename Compare = std::less<>>
+void ParallelSort(Vector& vector, Compare comp = Compare(), size_t threshold = kParallelThreshold) {
+    const size_t n = vector.GetSize();
+    auto first = vector.begin();
+    const size_t chunks = ParallelChunkCount(n, threshold);
+    if (chunks == 1) {
+        std::sort(first, first + n, comp);
+        return;
+    }
+    auto bound = [&](size_t chunk) {
+        return first + ParallelChunkBegin(n, chunks, std::min(chunk, chunks));
+    };
+    ParallelInvoke(chunks, [&](size_t chunk) {
+        std::sort(bound(chunk), bound(chunk + 1), comp);
+    });
+    for (size_t width = 1; width < chunks; width *= 2) {
+        const size_t merges = (chunks + 2 * width - 1) / (2 * width);
+        ParallelInvoke(merges, [&](size_t merge) {
+            const size_t left = merge * 2 * width;
+            if (left + width < chunks) {
+                std::inplace_merge(bound(left), bound(left + width), bound(left + 2 * width), comp);
+            }
+        });
+    }
+}
+
+// Сворачивает элементы вектора операцией op, начиная с init. Части сворачиваются
+// параллельно, поэтому op должна быть ассоциативной; для чисел с плавающей точкой
+// результат может отличаться от последовательного в младших разрядах
+template <typename Vector, typename Type, typename BinaryOp = std::plus<>>
+Type ParallelReduce(const Vector& vector, Type init, BinaryOp op = BinaryOp(),
+                    size_t threshold = kParallelThreshold) {
+    const size_t n = vector.GetSize();
+    auto first = vector.begin();
+    const size_t chunks = ParallelChunkCount(n, threshold);
+    if (chunks == 1) {
+        for (size_t i = 0; i < n; ++i) {
+            init = op(std::move(init), first[i]);
+        }
+        return init;
+    }
+    std::vector<std::optional<Type>> partials(chunks);
+    ParallelInvoke(chunks, [&](size_t chunk) {
+        const size_t begin = ParallelChunkBegin(n, chunks, chunk);
+        const size_t end = ParallelChunkBegin(n, chunks, chunk + 1);
+        Type partial(first[begin]);
+        for (size_t i = begin + 1; i < end; ++i) {
+            partial = op(std::move(partial), first[i]);
+        }
+        partials[chunk].emplace(std::move(partial));
+    });
+    for (std::optional<Type>& partial : partials) {
+        init = op(std::move(init), std::move(*partial));
+    }
+    return init;
+}
@@ -0,0 +1,382 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "parallel.h"
+#include "relocation.h"
+#include "vector_constexpr.h"
+#include "vector_stats.h"
+
+// Сообщают, определяет ли аллокатор собственные construct и destroy
+template <typename Allocator, typename Type, typename = void>
+inline constexpr bool kHasAllocatorConstruct = false;
+
+template <typename Allocator, typename Type>
+inline constexpr bool kHasAllocatorConstruct<Allocator, Type,
+        std::void_t<decltype(std::declval<Allocator&>().construct(std::declval<Type*>()))>> = true;
+
+template <typename Allocator, typename Type, typename = void>
+inline constexpr bool kHasAllocatorDestroy = false;
+
+template <typename Allocator, typename Type>
+inline constexpr bool kHasAllocatorDestroy<Allocator, Type,
+        std::void_t<decltype(std::declval<Allocator&>().destroy(std::declval<Type*>()))>> = true;
+
+// Владеет сырой (неинициализированной) памятью под capacity элементов типа Type,
+// полученной у аллокатора Allocator (совместимого с std::allocator, в том числе
+// std::pmr::polymorphic_allocator). В отличие от ArrayPtr, не конструирует и не
+// разрушает элементы сам: за время жизни объектов отвечает владелец RawMemory,
+// который создаёт и разрушает их через Construct/Destroy, чтобы аллокатор мог
+// передать себя элементам (uses-allocator construction)
+template <typename Type, typename Allocator = std::allocator<Type>>
+class RawMemory {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    static_assert(std::is_same_v<typename AllocatorTraits::value_type, Type>,
+                  "Allocator::value_type must be the same as Type");
+
+public:
+    // Буфер тривиально перемещаемых типов со стандартным аллокатором выделяется через
+    // malloc и может расти через realloc: аллокатор по возможности расширяет блок на
+    // месте, а крупные блоки glibc переотображает через mremap без копирования данных
+    static constexpr bool kCanReallocate = std::is_same_v<Allocator, std::allocator<Type>>
+            && kIsTriviallyRelocatable<Type>
+            && alignof(Type) <= alignof(std::max_align_t);
+
+    // Инициализирует RawMemory нулевым указателем
+    RawMemory() = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit RawMemory(const Allocator& allocator) noexcept
+            : allocator_(allocator) {
+    }
+
+    // Выделяет память под capacity элементов, не инициализируя её.
+    // Если capacity == 0, буфер равен nullptr
+    SIMPLE_VECTOR_CONSTEXPR explicit RawMemory(size_t capacity, const Allocator& allocator = Allocator())
+            : allocator_(allocator)
+            , buffer_(Allocate(capacity))
+            , capacity_(capacity) {
+    }
+
+    // Запрещаем копирование
+    RawMemory(const RawMemory&) = delete;
+
+    // Запрещаем присваивание
+    RawMemory& operator=(const RawMemory&) = delete;
+
+    //Конструктор перемещения. Аллокатор перемещается вместе с буфером
+    SIMPLE_VECTOR_CONSTEXPR RawMemory(RawMemory&& other) noexcept
+            : allocator_(std::move(other.allocator_))
+            , buffer_(std::exchange(other.buffer_, nullptr))
+            , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+
+    //Оператор перемещения. Прежний буфер освобождается, аллокатор переходит
+    //к *this, только если это разрешает propagate_on_container_move_assignment.
+    //Иначе аллокаторы обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR RawMemory& operator=(RawMemory&& other) noexcept {
+        if (this != &other) {
+            Deallocate(buffer_, capacity_);
+            if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+                allocator_ = std::move(other.allocator_);
+            } else {
+                assert(allocator_ == other.allocator_);
+            }
+            buffer_ = std::exchange(other.buffer_, nullptr);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ~RawMemory() {
+        Deallocate(buffer_, capacity_);
+    }
+
+    // Возвращает адрес ячейки с индексом offset. Допускается offset == capacity
+    SIMPLE_VECTOR_CONSTEXPR Type* operator+(size_t offset) noexcept {
+        return buffer_ + offset;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* operator+(size_t offset) const noexcept {
+        return buffer_ + offset;
+    }
+
+    // Возвращает ссылку на элемент. Ячейка должна содержать сконструированный объект
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
+        return buffer_[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
+        return buffer_[index];
+    }
+
+    // Возвращает адрес начала буфера
+    SIMPLE_VECTOR_CONSTEXPR Type* Get() const noexcept {
+        return buffer_;
+    }
+
+    // Возвращает количество ячеек в буфере
+    SIMPLE_VECTOR_CONSTEXPR size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Allocator& GetAllocator() const noexcept {
+        return allocator_;
+    }
+
+    // Освобождает буфер и заменяет аллокатор на allocator.
+    // Используется при propagate_on_container_copy_assignment
+    SIMPLE_VECTOR_CONSTEXPR void Reset(const Allocator& allocator) noexcept {
+        Deallocate(std::exchange(buffer_, nullptr), std::exchange(capacity_, 0));
+        allocator_ = allocator;
+    }
+
+    // Изменяет вместимость буфера, сохраняя его содержимое. Доступно при kCanReallocate.
+    // Если память выделить не удалось, бросает std::bad_alloc, буфер не изменяется
+    void Reallocate(size_t new_capacity) {
+        static_assert(kCanReallocate);
+        if (new_capacity == 0) {
+            Deallocate(std::exchange(buffer_, nullptr), capacity_);
+        } else {
+            void* buffer = std::realloc(static_cast<void*>(buffer_), ByteSize(new_capacity));
+            if (buffer == nullptr) {
+                throw std::bad_alloc();
+            }
+            buffer_ = static_cast<Type*>(buffer);
+            RecordAllocation<Type>(new_capacity * sizeof(Type));
+            RecordCapacity<Type>(new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
+    // Обменивается буферами с объектом other. Аллокаторы обмениваются, только если это
+    // разрешает propagate_on_container_swap, иначе они обязаны быть равны
+    SIMPLE_VECTOR_CONSTEXPR void swap(RawMemory& other) noexcept {
+        if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator_, other.allocator_);
+        } else {
+            assert(allocator_ == other.allocator_);
+        }
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // Конструирует объект в ячейке place через аллокатор
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR void Construct(Type* place, Args&&... args) {
+        AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+    }
+
+    // Разрушает объект в ячейке place через аллокатор
+    SIMPLE_VECTOR_CONSTEXPR void Destroy(Type* place) noexcept {
+        AllocatorTraits::destroy(allocator_, place);
+    }
+
+    // Разрушает n объектов, начиная с first
+    SIMPLE_VECTOR_CONSTEXPR void DestroyN(Type* first, size_t n) noexcept {
+        if constexpr (kUsesPlainConstruction) {
+            std::destroy_n(first, n);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                Destroy(first + i);
+            }
+        }
+    }
+
+    // Конструирует n объектов в неинициализированной памяти to, передавая каждому args.
+    // Без аргументов объекты инициализируются значением по умолчанию.
+    // Если конструктор бросил исключение, уже созданные объекты разрушаются
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR void ConstructN(Type* to, size_t n, const Args&... args) {
+        if (IsConstantEvaluated()) {
+            ConstructEachN(to, n, args...);
+        } else if constexpr (kUsesPlainConstruction && sizeof...(Args) == 0) {
+            if constexpr (std::is_nothrow_default_constructible_v<Type>) {
+                ParallelConstructFor(n, [to](size_t begin, size_t end) {
+                    std::uninitialized_value_construct_n(to + begin, end - begin);
+                });
+            } else {
+                std::uninitialized_value_construct_n(to, n);
+            }
+        } else if constexpr (kUsesPlainConstruction && sizeof...(Args) == 1) {
+            if constexpr (std::is_nothrow_copy_constructible_v<Type>) {
+                ParallelConstructFor(n, [to, &args...](size_t begin, size_t end) {
+                    std::uninitialized_fill_n(to + begin, end - begin, args...);
+                });
+            } else {
+                std::uninitialized_fill_n(to, n, args...);
+            }
+        } else {
+            ConstructEachN(to, n, args...);
+        }
+    }
+
+    // Конструирует n объектов в неинициализированной памяти to копиями элементов from.
+    // Непрерывный диапазон тривиально копируемых элементов копируется одним memcpy
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR void CopyConstructN(InputIt from, size_t n, Type* to) {
+        RecordCopies<Type>(n);
+        ConstructFromN(from, n, to);
+    }
+
+    // Конструирует n элементов в неинициализированной памяти to из элементов from.
+    // Элементы перемещаются, если перемещение не бросает исключений или копирование невозможно
+    SIMPLE_VECTOR_CONSTEXPR void MoveOrCopyConstructN(Type* from, size_t n, Type* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            RecordMoves<Type>(n);
+        } else {
+            RecordCopies<Type>(n);
+        }
+        if constexpr (kUsesPlainConstruction) {
+            if (!IsConstantEvaluated()) {
+                UninitializedMoveOrCopyN(from, n, to);
+                return;
+            }
+        }
+        if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+            ConstructFromN(std::make_move_iterator(from), n, to);
+        } else {
+            ConstructFromN(from, n, to);
+        }
+    }
+
+    // Переносит n элементов из from в неинициализированную память to.
+    // После успешного вызова ячейки from считаются сырой памятью. Если перенос
+    // бросил исключение, исходные элементы остаются на месте
+    SIMPLE_VECTOR_CONSTEXPR void RelocateN(Type* from, size_t n, Type* to) {
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            if (!IsConstantEvaluated()) {
+                RecordMoves<Type>(n);
+                UninitializedRelocateN(from, n, to);
+                return;
+            }
+        }
+        MoveOrCopyConstructN(from, n, to);
+        DestroyN(from, n);
+    }
+
+private:
+
+    // std::allocator и аллокаторы без собственных construct и destroy конструируют объекты
+    // обычным placement new, поэтому для них можно использовать стандартные алгоритмы
+    static constexpr bool kUsesPlainConstruction = std::is_same_v<Allocator, std::allocator<Type>>
+            || (!kHasAllocatorConstruct<Allocator, Type> && !kHasAllocatorDestroy<Allocator, Type>);
+
+    [[no_unique_address]] Allocator allocator_ = {};
+    Type* buffer_ = nullptr;
+    size_t capacity_ = 0;
+
+    // Заполняет n ячеек вызовами fill(begin, end), разделяя работу между потоками, если
+    // буфер не меньше kParallelConstructBytes. fill не должна бросать исключений: тогда
+    // исключение (нехватка памяти под служебные массивы) возможно только до начала заполнения
+    template <typename Fill>
+    static void ParallelConstructFor(size_t n, Fill fill) {
+        constexpr size_t kChunkElements = std::max(kParallelConstructBytes / sizeof(Type), size_t(1));
+        ParallelFor(n, kChunkElements, fill);
+    }
+
+    // Конструирует n объектов в памяти to из элементов, на которые указывает from
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR void ConstructFromN(InputIt from, size_t n, Type* to) {
+        if (IsConstantEvaluated()) {
+            ConstructEachFromN(from, n, to);
+        } else if constexpr (std::is_trivially_copyable_v<Type> && std::is_pointer_v<InputIt>
+                      && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<InputIt>>, Type>) {
+            ParallelConstructFor(n, [from, to](size_t begin, size_t end) {
+                std::memcpy(static_cast<void*>(to + begin), static_cast<const void*>(from + begin),
+                            (end - begin) * sizeof(Type));
+            });
+        } else if constexpr (kUsesPlainConstruction && std::is_nothrow_copy_constructible_v<Type>
+                             && std::is_pointer_v<InputIt>) {
+            ParallelConstructFor(n, [from, to](size_t begin, size_t end) {
+                std::uninitialized_copy_n(from + begin, end - begin, to + begin);
+            });
+        } else if constexpr (kUsesPlainConstruction) {
+            std::uninitialized_copy_n(from, n, to);
+        } else {
+            ConstructEachFromN(from, n, to);
+        }
+    }
+
+    // Конструируют n объектов по одному через аллокатор. Если конструктор бросил
+    // исключение, уже созданные объекты разрушаются
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR void ConstructEachN(Type* to, size_t n, const Args&... args) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i) {
+                Construct(to + i, args...);
+            }
+        } catch (...) {
+            DestroyN(to, i);
+            throw;
+        }
+    }
+
+    template <typename InputIt>
+    SIMPLE_VECTOR_CONSTEXPR void ConstructEachFromN(InputIt from, size_t n, Type* to) {
+        size_t i = 0;
+        try {
+            for (; i < n; ++i, ++from) {
+                Construct(to + i, *from);
+            }
+        } catch (...) {
+            DestroyN(to, i);
+            throw;
+        }
+    }
+
+    // Размер n элементов в байтах. Как new[] и std::allocator::allocate, бросает
+    // std::bad_array_new_length, если он не помещается в size_t
+    static size_t ByteSize(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(Type);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        if constexpr (kCanReallocate) {
+            // Константное выражение не может вызвать malloc, а освобождает буфер тоже оно
+            if (!IsConstantEvaluated()) {
+                const size_t bytes = ByteSize(n);
+                RecordAllocation<Type>(bytes);
+                RecordCapacity<Type>(n);
+                void* buffer = std::malloc(bytes);
+                if (buffer == nullptr) {
+                    throw std::bad_alloc();
+                }
+                return static_cast<Type*>(buffer);
+            }
+        }
+        RecordAllocation<Type>(n * sizeof(Type));
+        RecordCapacity<Type>(n);
+        return AllocatorTraits::allocate(allocator_, n);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Deallocate(Type* buffer, size_t n) noexcept {
+        if (buffer == nullptr) {
+            return;
+        }
+        if constexpr (kCanReallocate) {
+            if (!IsConstantEvaluated()) {
+                std::free(buffer);
+                return;
+            }
+        }
+        AllocatorTraits::deallocate(allocator_, buffer, n);
+    }
+
+};
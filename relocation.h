@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Сообщает, можно ли перенести объект типа Type в другую область памяти побайтовым
+// копированием, не вызывая конструктор перемещения и деструктор исходного объекта.
+// По умолчанию это верно для тривиально копируемых типов. Для собственных типов
+// (например, владеющих указателем на кучу) структуру можно специализировать:
+//
+//     template <>
+//     struct IsTriviallyRelocatable<MyHandle> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {};
+
+// std::unique_ptr со стандартным удалителем хранит только указатель и не ссылается сам на себя
+template <typename Type>
+struct IsTriviallyRelocatable<std::unique_ptr<Type>> : std::true_type {};
+
+template <typename Type>
+inline constexpr bool kIsTriviallyRelocatable = IsTriviallyRelocatable<Type>::value;
+
+// Конструирует n элементов в неинициализированной памяти to из элементов from.
+// Элементы перемещаются, если перемещение не бросает исключений или копирование невозможно
+template <typename Type>
+void UninitializedMoveOrCopyN(Type* from, size_t n, Type* to) {
+    if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+        std::uninitialized_move_n(from, n, to);
+    } else {
+        std::uninitialized_copy_n(from, n, to);
+    }
+}
+
+// Переносит n элементов из from в неинициализированную память to.
+// После успешного вызова ячейки from считаются сырой памятью. Если перенос
+// бросил исключение, исходные элементы остаются на месте
+template <typename Type>
+void UninitializedRelocateN(Type* from, size_t n, Type* to) {
+    if constexpr (kIsTriviallyRelocatable<Type>) {
+        if (n != 0) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(Type));
+        }
+    } else {
+        UninitializedMoveOrCopyN(from, n, to);
+        std::destroy_n(from, n);
+    }
+}
+
+// Сдвигает n тривиально перемещаемых элементов из from в to. Области могут перекрываться
+template <typename Type>
+void RelocateOverlappingN(Type* from, size_t n, Type* to) noexcept {
+    static_assert(kIsTriviallyRelocatable<Type>);
+    if (n != 0) {
+        std::memmove(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(Type));
+    }
+}
@@ -0,0 +1,660 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd_kernels.h"
+#include "simple_vector.h"
+#include "vector_checks.h"
+#include "vector_stats.h"
+
+// Разбиение индексов на сегменты удваивающегося размера: сегмент 0 вмещает
+// kFirstSegmentSize элементов, сегмент k — kFirstSegmentSize * 2^k. Сегмент элемента —
+// это номер старшего бита index + kFirstSegmentSize, поэтому адрес находится за O(1)
+struct SegmentLayout {
+    static constexpr size_t kFirstSegmentBits = 4;
+    // Размер первого сегмента, степень двойки
+    static constexpr size_t kFirstSegmentSize = size_t(1) << kFirstSegmentBits;
+    // Сегментов хватает на любой индекс, представимый в size_t
+    static constexpr size_t kSegmentCount = std::numeric_limits<size_t>::digits - kFirstSegmentBits;
+
+    // Сегмент и смещение элемента внутри него
+    struct Position {
+        size_t segment;
+        size_t offset;
+    };
+
+    static size_t FloorLog2(size_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        return std::numeric_limits<unsigned long long>::digits - 1 - __builtin_clzll(value);
+#else
+        size_t result = 0;
+        while (value >>= 1) {
+            ++result;
+        }
+        return result;
+#endif
+    }
+
+    static Position Locate(size_t index) noexcept {
+        const size_t biased = index + kFirstSegmentSize;
+        const size_t segment = FloorLog2(biased) - kFirstSegmentBits;
+        return {segment, biased - SegmentSize(segment)};
+    }
+
+    // Индекс первого элемента сегмента segment
+    static constexpr size_t SegmentStart(size_t segment) noexcept {
+        return (kFirstSegmentSize << segment) - kFirstSegmentSize;
+    }
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+};
+
+// Итератор произвольного доступа по сегментам. Хранит индекс элемента и границы текущего
+// сегмента, поэтому последовательный обход стоит нескольким указателям на шаг, а переход
+// к произвольному индексу — одному вычислению SegmentLayout::Locate
+template <typename Type>
+class SegmentedIterator {
+    using Segment = std::remove_const_t<Type>*;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<Type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Type*;
+    using reference = Type&;
+
+    SegmentedIterator() noexcept = default;
+
+    SegmentedIterator(const Segment* segments, size_t index) noexcept
+            : segments_(segments)
+            , index_(index) {
+        Resolve();
+    }
+
+    // Неконстантный итератор преобразуется в константный
+    template <typename Other, typename = std::enable_if_t<std::is_same_v<const Other, Type>
+                                                          && !std::is_same_v<Other, Type>>>
+    SegmentedIterator(const SegmentedIterator<Other>& other) noexcept
+            : segments_(other.segments_)
+            , index_(other.index_)
+            , ptr_(other.ptr_)
+            , segment_end_(other.segment_end_) {
+    }
+
+    // Возвращает индекс элемента в векторе
+    size_t GetIndex() const noexcept {
+        return index_;
+    }
+
+    reference operator*() const noexcept {
+        return *ptr_;
+    }
+
+    pointer operator->() const noexcept {
+        return ptr_;
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return *(*this + offset);
+    }
+
+    SegmentedIterator& operator++() noexcept {
+        ++index_;
+        if (++ptr_ == segment_end_) {
+            Resolve();
+        }
+        return *this;
+    }
+
+    SegmentedIterator operator++(int) noexcept {
+        SegmentedIterator copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    SegmentedIterator& operator--() noexcept {
+        --index_;
+        Resolve();
+        return *this;
+    }
+
+    SegmentedIterator operator--(int) noexcept {
+        SegmentedIterator copy = *this;
+        --*this;
+        return copy;
+    }
+
+    SegmentedIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        Resolve();
+        return *this;
+    }
+
+    SegmentedIterator& operator-=(difference_type offset) noexcept {
+        return *this += -offset;
+    }
+
+    friend SegmentedIterator operator+(SegmentedIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend SegmentedIterator operator+(difference_type offset, SegmentedIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend SegmentedIterator operator-(SegmentedIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_ - rhs.index_);
+    }
+
+    friend bool operator==(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend bool operator!=(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return lhs.index_ != rhs.index_;
+    }
+
+    friend bool operator<(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return lhs.index_ < rhs.index_;
+    }
+
+    friend bool operator>(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const SegmentedIterator& lhs, const SegmentedIterator& rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+private:
+    template <typename Other>
+    friend class SegmentedIterator;
+
+    const Segment* segments_ = nullptr;
+    size_t index_ = 0;
+    Type* ptr_ = nullptr;
+    Type* segment_end_ = nullptr;
+
+    // Находит элемент index_. За последним выделенным сегментом указатели остаются нулевыми
+    void Resolve() noexcept {
+        if (segments_ == nullptr) {
+            return;
+        }
+        const SegmentLayout::Position position = SegmentLayout::Locate(index_);
+        Type* first = segments_[position.segment];
+        if (first == nullptr) {
+            ptr_ = segment_end_ = nullptr;
+        } else {
+            ptr_ = first + position.offset;
+            segment_end_ = first + SegmentLayout::SegmentSize(position.segment);
+        }
+    }
+};
+
+// Вектор, который растёт, не перемещая элементы: память выделяется сегментами
+// удваивающегося размера (см. SegmentLayout), и новый сегмент добавляется к уже
+// выделенным. Поэтому указатели, ссылки и итераторы на элементы остаются
+// действительными при PushBack, EmplaceBack, Reserve и Resize в сторону увеличения,
+// а рост не копирует ни одного элемента. Доступ по индексу стоит нескольких
+// арифметических операций, итераторы учитывают границы сегментов.
+//
+// Интерфейс повторяет SimpleVector. Insert и Erase сдвигают элементы, как и там,
+// и делают недействительными ссылки на сдвинутые элементы. Итераторы, в отличие
+// от ссылок, не переживают перемещение и обмен вектора: сегменты переходят к другому
+// объекту, а итератор помнит таблицу сегментов прежнего
+template <typename Type, typename Allocator = std::allocator<Type>>
+class SegmentedVector {
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+    using Iterator = SegmentedIterator<Type>;
+    using ConstIterator = SegmentedIterator<const Type>;
+
+    // Перемещающее присваивание забирает сегменты, не выделяя памяти
+    static constexpr bool kNothrowMoveAssign = AllocatorTraits::propagate_on_container_move_assignment::value
+                                               || AllocatorTraits::is_always_equal::value;
+
+public:
+
+    using allocator_type = Allocator;
+
+    SegmentedVector() noexcept = default;
+
+    explicit SegmentedVector(const Allocator& allocator) noexcept
+            : allocator_(allocator) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SegmentedVector(size_t size, const Allocator& allocator = Allocator())
+            : SegmentedVector(allocator) {
+        Resize(size);
+    }
+
+    SegmentedVector(size_t size, const Type& value, const Allocator& allocator = Allocator())
+            : SegmentedVector(allocator) {
+        Reserve(size);
+        while (size_ < size) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : SegmentedVector(init.begin(), init.end(), allocator) {
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    SegmentedVector(InputIt first, InputIt last, const Allocator& allocator = Allocator())
+            : SegmentedVector(allocator) {
+        if constexpr (kIsForwardIterator<InputIt>) {
+            Reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+            : SegmentedVector(other.begin(), other.end(),
+                              AllocatorTraits::select_on_container_copy_construction(other.allocator_)) {
+    }
+
+    SegmentedVector(const SegmentedVector& other, const Allocator& allocator)
+            : SegmentedVector(other.begin(), other.end(), allocator) {
+    }
+
+    // Забирает сегменты other. Аллокатор перемещается вместе с ними
+    SegmentedVector(SegmentedVector&& other) noexcept
+            : allocator_(other.allocator_) {
+        StealSegments(other);
+    }
+
+    // Если аллокаторы не равны, элементы перемещаются по одному в новые сегменты
+    SegmentedVector(SegmentedVector&& other, const Allocator& allocator)
+            : allocator_(allocator) {
+        if (allocator_ == other.allocator_) {
+            StealSegments(other);
+        } else {
+            try {
+                Reserve(other.size_);
+                for (Type& value : other) {
+                    EmplaceBack(std::move_if_noexcept(value));
+                }
+            } catch (...) {
+                // Деструктор недостроенного объекта не вызывается
+                Clear();
+                ReleaseSegments(0);
+                throw;
+            }
+            other.Clear();
+        }
+    }
+
+    // Аллокатор *this сохраняется, если его не требуется заменить
+    // по propagate_on_container_copy_assignment
+    SegmentedVector& operator=(const SegmentedVector& other) {
+        if (this != &other) {
+            if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+                if (allocator_ != other.allocator_) {
+                    Clear();
+                    ReleaseSegments(0);
+                    allocator_ = other.allocator_;
+                }
+            }
+            SegmentedVector copy(other, allocator_);
+            SwapSegments(copy);
+        }
+        return *this;
+    }
+
+    // Забирает сегменты other, если аллокатор передаётся или аллокаторы равны.
+    // Иначе элементы перемещаются по одному в память аллокатора *this
+    SegmentedVector& operator=(SegmentedVector&& other) noexcept(kNothrowMoveAssign) {
+        if (this != &other) {
+            if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+                Clear();
+                ReleaseSegments(0);
+                allocator_ = other.allocator_;
+                StealSegments(other);
+            } else {
+                SegmentedVector temp(std::move(other), allocator_);
+                SwapSegments(temp);
+            }
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+        ReleaseSegments(0);
+    }
+
+    Allocator GetAllocator() const noexcept {
+        return allocator_;
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает число элементов в выделенных сегментах
+    size_t GetCapacity() const noexcept {
+        return SegmentLayout::SegmentStart(segment_count_);
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // В проверяемом режиме index >= size считается ошибкой
+    Type& operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return *Slot(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return *Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *Slot(index);
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return *Slot(index);
+    }
+
+    // Возвращает итератор на первый элемент, равный value, или end().
+    // Для арифметических типов каждый сегмент просматривается векторизованно
+    Iterator Find(const Type& value) noexcept(simd::kHasKernels<Type>) {
+        return begin() + (std::as_const(*this).Find(value) - cbegin());
+    }
+
+    ConstIterator Find(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        for (size_t segment = 0; SegmentLayout::SegmentStart(segment) < size_; ++segment) {
+            const size_t start = SegmentLayout::SegmentStart(segment);
+            const size_t count = std::min(SegmentLayout::SegmentSize(segment), size_ - start);
+            const size_t found = simd::Find(segments_[segment], count, value);
+            if (found != count) {
+                return cbegin() + (start + found);
+            }
+        }
+        return cend();
+    }
+
+    bool Contains(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Find(value) != cend();
+    }
+
+    size_t Count(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        size_t result = 0;
+        for (size_t segment = 0; SegmentLayout::SegmentStart(segment) < size_; ++segment) {
+            const size_t start = SegmentLayout::SegmentStart(segment);
+            result += simd::Count(segments_[segment], std::min(SegmentLayout::SegmentSize(segment), size_ - start), value);
+        }
+        return result;
+    }
+
+    // Разрушает элементы, сохраняя выделенные сегменты
+    void Clear() noexcept {
+        DestroyTail(0);
+    }
+
+    // Выделяет сегменты, пока вместимость не станет не меньше new_capacity.
+    // Элементы не перемещаются
+    void Reserve(size_t new_capacity) {
+        while (GetCapacity() < new_capacity) {
+            AddSegment();
+        }
+    }
+
+    // Освобождает сегменты, в которых не осталось элементов
+    void ShrinkToFit() noexcept {
+        size_t used = 0;
+        while (SegmentLayout::SegmentStart(used) < size_) {
+            ++used;
+        }
+        ReleaseSegments(used);
+    }
+
+    // Изменяет размер. Новые элементы инициализируются значением по умолчанию.
+    // Если конструктор бросил исключение, размер не меняется
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyTail(new_size);
+            return;
+        }
+        Reserve(new_size);
+        const size_t old_size = size_;
+        try {
+            while (size_ < new_size) {
+                AllocatorTraits::construct(allocator_, Slot(size_));
+                ++size_;
+            }
+        } catch (...) {
+            DestroyTail(old_size);
+            throw;
+        }
+    }
+
+    void PushBack(const Type& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Конструирует элемент в конце и возвращает ссылку на него. Элементы не перемещаются,
+    // поэтому args могут ссылаться на элементы самого вектора
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            AddSegment();
+        }
+        Type* place = Slot(size_);
+        AllocatorTraits::construct(allocator_, place, std::forward<Args>(args)...);
+        ++size_;
+        return *place;
+    }
+
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            DestroyTail(size_ - 1);
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент перед pos: дописывает его в конец и поворачивает хвост
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t index = pos.GetIndex();
+        SIMPLE_VECTOR_CHECK(index <= size_, "iterator out of range");
+        EmplaceBack(std::forward<Args>(args)...);
+        std::rotate(begin() + index, end() - 1, end());
+        return begin() + index;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        SIMPLE_VECTOR_CHECK(pos.GetIndex() < size_, "erasing the end iterator");
+        return Erase(pos, pos + 1);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t index = first.GetIndex();
+        const size_t count = last.GetIndex() - index;
+        SIMPLE_VECTOR_CHECK(index <= last.GetIndex() && last.GetIndex() <= size_, "erased range out of range");
+        std::move(begin() + (index + count), end(), begin() + index);
+        DestroyTail(size_ - count);
+        return begin() + index;
+    }
+
+    Iterator begin() noexcept {
+        return {segments_, 0};
+    }
+
+    Iterator end() noexcept {
+        return {segments_, size_};
+    }
+
+    ConstIterator begin() const noexcept {
+        return cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return {segments_, 0};
+    }
+
+    ConstIterator cend() const noexcept {
+        return {segments_, size_};
+    }
+
+    // Обменивается содержимым с other. Аллокаторы обмениваются, только если это
+    // разрешает propagate_on_container_swap, иначе они обязаны быть равны
+    void swap(SegmentedVector& other) noexcept {
+        if constexpr (AllocatorTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator_, other.allocator_);
+        } else {
+            assert(allocator_ == other.allocator_);
+        }
+        SwapSegments(other);
+    }
+
+    // Вызывает fn(first, count) для заполненной части каждого сегмента по порядку
+    template <typename Fn>
+    void ForEachSegment(Fn fn) const {
+        for (size_t segment = 0; SegmentLayout::SegmentStart(segment) < size_; ++segment) {
+            const size_t start = SegmentLayout::SegmentStart(segment);
+            fn(static_cast<const Type*>(segments_[segment]), std::min(SegmentLayout::SegmentSize(segment), size_ - start));
+        }
+    }
+
+private:
+
+    [[no_unique_address]] Allocator allocator_ = {};
+    // Выделены сегменты [0, segment_count_), остальные указатели нулевые
+    Type* segments_[SegmentLayout::kSegmentCount] = {};
+    size_t segment_count_ = 0;
+    size_t size_ = 0;
+
+    Type* Slot(size_t index) const noexcept {
+        const SegmentLayout::Position position = SegmentLayout::Locate(index);
+        return segments_[position.segment] + position.offset;
+    }
+
+    void AddSegment() {
+        const size_t size = SegmentLayout::SegmentSize(segment_count_);
+        segments_[segment_count_] = AllocatorTraits::allocate(allocator_, size);
+        RecordAllocation<Type>(size * sizeof(Type));
+        RecordCapacity<Type>(SegmentLayout::SegmentStart(segment_count_ + 1));
+        ++segment_count_;
+    }
+
+    // Освобождает сегменты, начиная с first. В них не должно быть элементов
+    void ReleaseSegments(size_t first) noexcept {
+        while (segment_count_ > first) {
+            --segment_count_;
+            AllocatorTraits::deallocate(allocator_, std::exchange(segments_[segment_count_], nullptr),
+                                        SegmentLayout::SegmentSize(segment_count_));
+        }
+    }
+
+    // Разрушает элементы, начиная с new_size, от последнего к первому
+    void DestroyTail(size_t new_size) noexcept {
+        while (size_ > new_size) {
+            --size_;
+            AllocatorTraits::destroy(allocator_, Slot(size_));
+        }
+    }
+
+    // Обменивается сегментами с other, аллокаторы которого равны аллокаторам *this
+    void SwapSegments(SegmentedVector& other) noexcept {
+        std::swap(segments_, other.segments_);
+        std::swap(segment_count_, other.segment_count_);
+        std::swap(size_, other.size_);
+    }
+
+    void StealSegments(SegmentedVector& other) noexcept {
+        std::copy(std::begin(other.segments_), std::end(other.segments_), segments_);
+        std::fill(std::begin(other.segments_), std::end(other.segments_), nullptr);
+        segment_count_ = std::exchange(other.segment_count_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+};
+
+// Векторы одного размера разбиты на сегменты одинаково, поэтому сравниваются посегментно
+template <typename Type, typename Allocator>
+bool operator==(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    bool equal = true;
+    size_t start = 0;
+    lhs.ForEachSegment([&](const Type* first, size_t count) {
+        equal = equal && simd::Equal(first, count, &rhs[start], count);
+        start += count;
+    });
+    return equal;
+}
+
+template <typename Type, typename Allocator>
+bool operator!=(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator>
+bool operator<(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, typename Allocator>
+bool operator>(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, typename Allocator>
+bool operator<=(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, typename Allocator>
+bool operator>=(const SegmentedVector<Type, Allocator>& lhs, const SegmentedVector<Type, Allocator>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "simple_vector.h"
+
+// Двоичная сериализация SimpleVector. Поток начинается с заголовка SerializedHeader,
+// за которым следуют элементы. Тривиально копируемые элементы записываются и читаются
+// одним блоком, остальные — по одному через Serializer<Type>:
+//
+//     std::ofstream file("keys.bin", std::ios::binary);
+//     Serialize(file, keys);
+//
+// Числа записываются в порядке байтов машины; поток с другим порядком байтов
+// распознаётся по заголовку и отвергается
+
+// Заголовок сериализованного вектора. Занимает 32 байта, чтобы элементы
+// в буфере, выровненном по 32 байтам, тоже оказались выровнены
+struct SerializedHeader {
+    static constexpr uint32_t kMagic = 0x63655653;  // "SVec" на little-endian машине
+    static constexpr uint32_t kByteSwappedMagic = 0x53566563;
+    static constexpr uint16_t kVersion = 1;
+
+    // Элементы записаны одним блоком байтов
+    static constexpr uint16_t kRawElements = 1;
+
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t flags = 0;
+    uint32_t element_size = 0;
+    uint32_t reserved = 0;
+    uint64_t count = 0;
+    uint64_t padding = 0;
+};
+
+static_assert(sizeof(SerializedHeader) == 32);
+
+// Записывает и читает один элемент типа Type. Определён для тривиально копируемых типов,
+// std::string и вложенных SimpleVector. Для своих типов его можно специализировать:
+//
+//     template <>
+//     struct Serializer<Person> {
+//         static void Write(std::ostream& output, const Person& person);
+//         static void Read(std::istream& input, Person& person);
+//     };
+template <typename Type, typename = void>
+struct Serializer;
+
+// Проверяет состояние потока после записи или чтения
+inline void CheckStream(const std::ios& stream, const char* what) {
+    if (!stream) {
+        throw std::runtime_error(what);
+    }
+}
+
+template <typename Type>
+struct Serializer<Type, std::enable_if_t<std::is_trivially_copyable_v<Type>>> {
+    static void Write(std::ostream& output, const Type& value) {
+        output.write(reinterpret_cast<const char*>(&value), sizeof(Type));
+    }
+
+    static void Read(std::istream& input, Type& value) {
+        input.read(reinterpret_cast<char*>(&value), sizeof(Type));
+        CheckStream(input, "Serialized vector is truncated");
+    }
+};
+
+// Строка записывается как длина (uint64_t) и байты без завершающего нуля
+template <typename Char, typename Traits, typename Allocator>
+struct Serializer<std::basic_string<Char, Traits, Allocator>> {
+    static_assert(std::is_trivially_copyable_v<Char>);
+
+    static void Write(std::ostream& output, const std::basic_string<Char, Traits, Allocator>& value) {
+        Serializer<uint64_t>::Write(output, value.size());
+        output.write(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(Char));
+    }
+
+    static void Read(std::istream& input, std::basic_string<Char, Traits, Allocator>& value) {
+        uint64_t size = 0;
+        Serializer<uint64_t>::Read(input, size);
+        value.clear();
+        // Длина не проверена, поэтому строка растёт по мере чтения, а не выделяется заранее
+        constexpr uint64_t kChunk = 4096;
+        for (uint64_t done = 0; done < size;) {
+            const size_t chunk = static_cast<size_t>(std::min(kChunk, size - done));
+            value.resize(value.size() + chunk);
+            input.read(reinterpret_cast<char*>(value.data() + done), chunk * sizeof(Char));
+            CheckStream(input, "Serialized vector is truncated");
+            done += chunk;
+        }
+    }
+};
+
+// Записывает заголовок и элементы vector в поток output.
+// Бросает std::runtime_error, если запись не удалась
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Serialize(std::ostream& output, const SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+    SerializedHeader header;
+    header.element_size = sizeof(Type);
+    header.count = vector.GetSize();
+    if constexpr (std::is_trivially_copyable_v<Type>) {
+        header.flags |= SerializedHeader::kRawElements;
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if constexpr (std::is_trivially_copyable_v<Type>) {
+        output.write(reinterpret_cast<const char*>(vector.Data()), vector.GetSize() * sizeof(Type));
+    } else {
+        for (const Type& item : vector) {
+            Serializer<Type>::Write(output, item);
+        }
+    }
+    CheckStream(output, "Failed to write serialized vector");
+}
+
+// Проверяет заголовок. Бросает std::runtime_error, если он не подходит для Type
+template <typename Type>
+void ValidateSerializedHeader(const SerializedHeader& header) {
+    if (header.magic == SerializedHeader::kByteSwappedMagic) {
+        throw std::runtime_error("Serialized vector has a different byte order");
+    }
+    if (header.magic != SerializedHeader::kMagic || header.version != SerializedHeader::kVersion) {
+        throw std::runtime_error("Serialized vector has an unknown format");
+    }
+    const bool raw = (header.flags & SerializedHeader::kRawElements) != 0;
+    if (header.element_size != sizeof(Type) || raw != std::is_trivially_copyable_v<Type>) {
+        throw std::runtime_error("Serialized vector holds elements of a different type");
+    }
+}
+
+// Заменяет содержимое vector элементами из потока input. Бросает std::runtime_error,
+// если заголовок не подходит для Type или поток закончился раньше времени; тогда vector
+// содержит уже прочитанную часть. Нетривиальные элементы должны иметь конструктор по умолчанию
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Deserialize(std::istream& input, SimpleVector<Type, Allocator, GrowthPolicy>& vector) {
+    SerializedHeader header;
+    input.read(reinterpret_cast<char*>(&header), sizeof(header));
+    CheckStream(input, "Serialized vector is truncated");
+    ValidateSerializedHeader<Type>(header);
+    vector.Clear();
+    // Число элементов пришло извне, поэтому память выделяется по мере поступления данных
+    constexpr uint64_t kChunkBytes = uint64_t(1) << 20;
+    if constexpr (std::is_trivially_copyable_v<Type>) {
+        const uint64_t chunk_elements = std::max<uint64_t>(kChunkBytes / sizeof(Type), 1);
+        for (uint64_t done = 0; done < header.count;) {
+            const size_t chunk = static_cast<size_t>(std::min(chunk_elements, header.count - done));
+            vector.Resize(vector.GetSize() + chunk);
+            input.read(reinterpret_cast<char*>(vector.Data() + done), chunk * sizeof(Type));
+            CheckStream(input, "Serialized vector is truncated");
+            done += chunk;
+        }
+    } else {
+        vector.Reserve(static_cast<size_t>(std::min<uint64_t>(header.count, kChunkBytes / sizeof(Type))));
+        for (uint64_t i = 0; i < header.count; ++i) {
+            Serializer<Type>::Read(input, vector.EmplaceBack());
+        }
+    }
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+struct Serializer<SimpleVector<Type, Allocator, GrowthPolicy>> {
+    static void Write(std::ostream& output, const SimpleVector<Type, Allocator, GrowthPolicy>& value) {
+        Serialize(output, value);
+    }
+
+    static void Read(std::istream& input, SimpleVector<Type, Allocator, GrowthPolicy>& value) {
+        Deserialize(input, value);
+    }
+};
+
+// Неизменяемое представление сериализованного вектора тривиально копируемых элементов
+// поверх чужого буфера: отображённого файла, принятого сетевого пакета. Ничего не копирует,
+// поэтому буфер должен жить дольше представления
+template <typename Type>
+class SimpleVectorView {
+    static_assert(std::is_trivially_copyable_v<Type>, "SimpleVectorView reads raw bytes of its elements");
+
+    using ConstIterator = const Type*;
+
+public:
+
+    SimpleVectorView() noexcept = default;
+
+    // Разбирает буфер data длиной size байт, записанный Serialize. Бросает std::runtime_error,
+    // если заголовок не подходит для Type, буфер короче записанных элементов
+    // или элементы в нём не выровнены для Type
+    SimpleVectorView(const void* data, size_t size) {
+        if (size < sizeof(SerializedHeader)) {
+            throw std::runtime_error("Serialized vector is truncated");
+        }
+        SerializedHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        ValidateSerializedHeader<Type>(header);
+        if (header.count > (size - sizeof(SerializedHeader)) / sizeof(Type)) {
+            throw std::runtime_error("Serialized vector is truncated");
+        }
+        const std::byte* elements = static_cast<const std::byte*>(data) + sizeof(SerializedHeader);
+        if (reinterpret_cast<uintptr_t>(elements) % alignof(Type) != 0) {
+            throw std::runtime_error("Serialized vector elements are misaligned");
+        }
+        data_ = reinterpret_cast<const Type*>(elements);
+        size_ = static_cast<size_t>(header.count);
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает число байт буфера, занятых вектором вместе с заголовком
+    size_t GetSerializedSize() const noexcept {
+        return sizeof(SerializedHeader) + size_ * sizeof(Type);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index или бросает std::out_of_range
+    const Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    const Type* data_ = nullptr;
+    size_t size_ = 0;
+};
@@ -0,0 +1,619 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Векторизованные ядра сравнения и поиска для массивов арифметических типов.
+// На x86-64 базовый вариант использует SSE2, а AVX2 выбирается во время выполнения,
+// если его поддерживает процессор (GCC и Clang). На AArch64 используется NEON.
+// На остальных платформах и для неарифметических типов выполняются обычные циклы.
+//
+// Результаты совпадают со стандартными алгоритмами: числа с плавающей точкой
+// сравниваются по значению (-0.0 == 0.0, NaN не равен ничему, в том числе себе).
+//
+// Для BitVector здесь же собраны ядра над массивами 64-битных слов: подсчёт единиц
+// аппаратным popcnt (выбирается во время выполнения), поиск ненулевого слова и
+// побитовые операции над парой массивов
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMPLE_VECTOR_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMPLE_VECTOR_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define SIMPLE_VECTOR_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace simd {
+
+namespace detail {
+
+// Тип дорожки вектора, в которой обрабатываются элементы типа Type:
+// целые сравниваются побитово как беззнаковые того же размера
+template <typename Type, typename = void>
+struct LaneFor {
+    using type = void;
+};
+
+template <typename Type>
+struct LaneFor<Type, std::enable_if_t<std::is_integral_v<Type>>> {
+    using type = std::conditional_t<sizeof(Type) == 1, uint8_t,
+                 std::conditional_t<sizeof(Type) == 2, uint16_t,
+                 std::conditional_t<sizeof(Type) == 4, uint32_t,
+                 std::conditional_t<sizeof(Type) == 8, uint64_t, void>>>>;
+};
+
+template <>
+struct LaneFor<float> {
+    using type = float;
+};
+
+template <>
+struct LaneFor<double> {
+    using type = double;
+};
+
+template <typename Type>
+using Lane = typename LaneFor<std::remove_cv_t<Type>>::type;
+
+inline unsigned CountTrailingZeros(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#else
+    unsigned count = 0;
+    while ((value & 1) == 0) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+inline unsigned PopCount(uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(value));
+#else
+    unsigned count = 0;
+    for (; value != 0; value &= value - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Каждый набор инструкций описывается структурой с размером блока kBytes и функциями
+// EqualMask и MatchMask, которые читают блоки из памяти и возвращают маску, где каждому
+// байту блока соответствует kBitsPerByte бит; биты дорожки установлены, если её значения равны.
+// Векторные типы не выходят за пределы структуры: иначе их передача между функциями,
+// собранными с AVX2 и без него, нарушала бы соглашение о вызовах
+
+#ifdef SIMPLE_VECTOR_SIMD_SSE2
+struct Sse2 {
+    static constexpr size_t kBytes = 16;
+    static constexpr unsigned kBitsPerByte = 1;
+    static constexpr uint64_t kFullMask = 0xFFFF;
+
+    // Маска равенства дорожек в блоках по адресам lhs и rhs
+    template <typename LaneType>
+    static uint64_t EqualMask(const void* lhs, const void* rhs) noexcept {
+        return CompareEqual<LaneType>(Load(lhs), Load(rhs));
+    }
+
+    // Маска дорожек блока по адресу data, равных value
+    template <typename LaneType>
+    static uint64_t MatchMask(const void* data, LaneType value) noexcept {
+        return CompareEqual<LaneType>(Load(data), Splat<LaneType>(value));
+    }
+
+private:
+    using Vec = __m128i;
+
+    static Vec Load(const void* address) noexcept {
+        return _mm_loadu_si128(static_cast<const __m128i*>(address));
+    }
+
+    template <typename LaneType>
+    static Vec Splat(LaneType value) noexcept {
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            return _mm_set1_epi8(static_cast<char>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            return _mm_set1_epi16(static_cast<short>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            return _mm_set1_epi32(static_cast<int>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            return _mm_castps_si128(_mm_set1_ps(value));
+        } else {
+            return _mm_castpd_si128(_mm_set1_pd(value));
+        }
+    }
+
+    template <typename LaneType>
+    static uint64_t CompareEqual(Vec lhs, Vec rhs) noexcept {
+        Vec equal;
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            equal = _mm_cmpeq_epi8(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            equal = _mm_cmpeq_epi16(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            equal = _mm_cmpeq_epi32(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            // В SSE2 нет сравнения 64-битных дорожек: обе 32-битные половины должны совпасть
+            const Vec halves = _mm_cmpeq_epi32(lhs, rhs);
+            equal = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            equal = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(lhs), _mm_castsi128_ps(rhs)));
+        } else {
+            equal = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(lhs), _mm_castsi128_pd(rhs)));
+        }
+        return static_cast<uint32_t>(_mm_movemask_epi8(equal));
+    }
+};
+#endif
+
+#ifdef SIMPLE_VECTOR_SIMD_AVX2
+#define SIMPLE_VECTOR_TARGET_AVX2 __attribute__((target("avx2")))
+
+struct Avx2 {
+    static constexpr size_t kBytes = 32;
+    static constexpr unsigned kBitsPerByte = 1;
+    static constexpr uint64_t kFullMask = 0xFFFFFFFF;
+
+    // Маска равенства дорожек в блоках по адресам lhs и rhs
+    template <typename LaneType>
+    SIMPLE_VECTOR_TARGET_AVX2 static uint64_t EqualMask(const void* lhs, const void* rhs) noexcept {
+        return CompareEqual<LaneType>(Load(lhs), Load(rhs));
+    }
+
+    // Маска дорожек блока по адресу data, равных value
+    template <typename LaneType>
+    SIMPLE_VECTOR_TARGET_AVX2 static uint64_t MatchMask(const void* data, LaneType value) noexcept {
+        return CompareEqual<LaneType>(Load(data), Splat<LaneType>(value));
+    }
+
+private:
+    using Vec = __m256i;
+
+    SIMPLE_VECTOR_TARGET_AVX2 static Vec Load(const void* address) noexcept {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(address));
+    }
+
+    template <typename LaneType>
+    SIMPLE_VECTOR_TARGET_AVX2 static Vec Splat(LaneType value) noexcept {
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            return _mm256_set1_epi8(static_cast<char>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            return _mm256_set1_epi16(static_cast<short>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            return _mm256_set1_epi32(static_cast<int>(value));
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            return _mm256_set1_epi64x(static_cast<long long>(value));
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            return _mm256_castps_si256(_mm256_set1_ps(value));
+        } else {
+            return _mm256_castpd_si256(_mm256_set1_pd(value));
+        }
+    }
+
+    template <typename LaneType>
+    SIMPLE_VECTOR_TARGET_AVX2 static uint64_t CompareEqual(Vec lhs, Vec rhs) noexcept {
+        Vec equal;
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            equal = _mm256_cmpeq_epi8(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            equal = _mm256_cmpeq_epi16(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            equal = _mm256_cmpeq_epi32(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            equal = _mm256_cmpeq_epi64(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            equal = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(lhs), _mm256_castsi256_ps(rhs), _CMP_EQ_OQ));
+        } else {
+            equal = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(lhs), _mm256_castsi256_pd(rhs), _CMP_EQ_OQ));
+        }
+        return static_cast<uint32_t>(_mm256_movemask_epi8(equal));
+    }
+};
+#endif
+
+#ifdef SIMPLE_VECTOR_SIMD_NEON
+struct Neon {
+    static constexpr size_t kBytes = 16;
+    // В NEON нет movemask: маска собирается сдвигом с сужением, по 4 бита на байт
+    static constexpr unsigned kBitsPerByte = 4;
+    static constexpr uint64_t kFullMask = ~uint64_t(0);
+
+    // Маска равенства дорожек в блоках по адресам lhs и rhs
+    template <typename LaneType>
+    static uint64_t EqualMask(const void* lhs, const void* rhs) noexcept {
+        return CompareEqual<LaneType>(Load(lhs), Load(rhs));
+    }
+
+    // Маска дорожек блока по адресу data, равных value
+    template <typename LaneType>
+    static uint64_t MatchMask(const void* data, LaneType value) noexcept {
+        return CompareEqual<LaneType>(Load(data), Splat<LaneType>(value));
+    }
+
+private:
+    using Vec = uint8x16_t;
+
+    static Vec Load(const void* address) noexcept {
+        return vld1q_u8(static_cast<const uint8_t*>(address));
+    }
+
+    template <typename LaneType>
+    static Vec Splat(LaneType value) noexcept {
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            return vdupq_n_u8(value);
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            return vreinterpretq_u8_u16(vdupq_n_u16(value));
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            return vreinterpretq_u8_u32(vdupq_n_u32(value));
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            return vreinterpretq_u8_u64(vdupq_n_u64(value));
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            return vreinterpretq_u8_f32(vdupq_n_f32(value));
+        } else {
+            return vreinterpretq_u8_f64(vdupq_n_f64(value));
+        }
+    }
+
+    template <typename LaneType>
+    static uint64_t CompareEqual(Vec lhs, Vec rhs) noexcept {
+        Vec equal;
+        if constexpr (std::is_same_v<LaneType, uint8_t>) {
+            equal = vceqq_u8(lhs, rhs);
+        } else if constexpr (std::is_same_v<LaneType, uint16_t>) {
+            equal = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(lhs), vreinterpretq_u16_u8(rhs)));
+        } else if constexpr (std::is_same_v<LaneType, uint32_t>) {
+            equal = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(lhs), vreinterpretq_u32_u8(rhs)));
+        } else if constexpr (std::is_same_v<LaneType, uint64_t>) {
+            equal = vreinterpretq_u8_u64(vceqq_u64(vreinterpretq_u64_u8(lhs), vreinterpretq_u64_u8(rhs)));
+        } else if constexpr (std::is_same_v<LaneType, float>) {
+            equal = vreinterpretq_u8_u32(vceqq_f32(vreinterpretq_f32_u8(lhs), vreinterpretq_f32_u8(rhs)));
+        } else {
+            equal = vreinterpretq_u8_u64(vceqq_f64(vreinterpretq_f64_u8(lhs), vreinterpretq_f64_u8(rhs)));
+        }
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(equal), 4)), 0);
+    }
+};
+#endif
+
+// Обобщённые ядра над набором инструкций Isa. Хвост короче вектора обрабатывается
+// обычным циклом по исходному типу Type
+
+template <typename Isa, typename Type>
+size_t MismatchBlocks(const Type* lhs, const Type* rhs, size_t n) noexcept {
+    using LaneType = Lane<Type>;
+    constexpr size_t kLanes = Isa::kBytes / sizeof(Type);
+    constexpr unsigned kBitsPerLane = Isa::kBitsPerByte * sizeof(Type);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        const uint64_t mask = Isa::template EqualMask<LaneType>(lhs + i, rhs + i);
+        if (mask != Isa::kFullMask) {
+            return i + CountTrailingZeros(~mask) / kBitsPerLane;
+        }
+    }
+    for (; i < n; ++i) {
+        if (!(lhs[i] == rhs[i])) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename Isa, typename Type>
+size_t FindBlocks(const Type* data, size_t n, Type value) noexcept {
+    using LaneType = Lane<Type>;
+    constexpr size_t kLanes = Isa::kBytes / sizeof(Type);
+    constexpr unsigned kBitsPerLane = Isa::kBitsPerByte * sizeof(Type);
+    const LaneType needle = static_cast<LaneType>(value);
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        const uint64_t mask = Isa::template MatchMask<LaneType>(data + i, needle);
+        if (mask != 0) {
+            return i + CountTrailingZeros(mask) / kBitsPerLane;
+        }
+    }
+    for (; i < n; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename Isa, typename Type>
+size_t CountBlocks(const Type* data, size_t n, Type value) noexcept {
+    using LaneType = Lane<Type>;
+    constexpr size_t kLanes = Isa::kBytes / sizeof(Type);
+    constexpr unsigned kBitsPerLane = Isa::kBitsPerByte * sizeof(Type);
+    const LaneType needle = static_cast<LaneType>(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + kLanes <= n; i += kLanes) {
+        count += PopCount(Isa::template MatchMask<LaneType>(data + i, needle)) / kBitsPerLane;
+    }
+    for (; i < n; ++i) {
+        count += data[i] == value;
+    }
+    return count;
+}
+
+#ifdef SIMPLE_VECTOR_SIMD_AVX2
+// Обёртки компилируются с AVX2, а flatten встраивает в них обобщённые ядра целиком,
+// поэтому инструкции AVX2 не попадают в код, который выполняется без проверки процессора
+template <typename Type>
+__attribute__((target("avx2"), flatten)) size_t MismatchAvx2(const Type* lhs, const Type* rhs, size_t n) noexcept {
+    return MismatchBlocks<Avx2>(lhs, rhs, n);
+}
+
+template <typename Type>
+__attribute__((target("avx2"), flatten)) size_t FindAvx2(const Type* data, size_t n, Type value) noexcept {
+    return FindBlocks<Avx2>(data, n, value);
+}
+
+template <typename Type>
+__attribute__((target("avx2"), flatten)) size_t CountAvx2(const Type* data, size_t n, Type value) noexcept {
+    return CountBlocks<Avx2>(data, n, value);
+}
+
+inline bool HasAvx2() noexcept {
+    static const bool has_avx2 = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return has_avx2;
+}
+#endif
+
+// Ядра над массивами 64-битных слов для BitVector
+
+// Операция над парой слов, которую CombineWords применяет ко всему массиву
+enum class WordOp {
+    kAnd,
+    kOr,
+    kXor,
+    kAndNot,
+};
+
+template <WordOp Op>
+inline uint64_t ApplyWordOp(uint64_t lhs, uint64_t rhs) noexcept {
+    if constexpr (Op == WordOp::kAnd) {
+        return lhs & rhs;
+    } else if constexpr (Op == WordOp::kOr) {
+        return lhs | rhs;
+    } else if constexpr (Op == WordOp::kXor) {
+        return lhs ^ rhs;
+    } else {
+        return lhs & ~rhs;
+    }
+}
+
+// Четыре независимых счётчика не ждут друг друга в конвейере
+inline size_t PopCountWordsScalar(const uint64_t* words, size_t n) noexcept {
+    size_t counts[4] = {};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        counts[0] += PopCount(words[i]);
+        counts[1] += PopCount(words[i + 1]);
+        counts[2] += PopCount(words[i + 2]);
+        counts[3] += PopCount(words[i + 3]);
+    }
+    for (; i < n; ++i) {
+        counts[0] += PopCount(words[i]);
+    }
+    return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+// Слова проверяются по четыре: одно ветвление на 256 бит
+inline size_t FindNonZeroWordScalar(const uint64_t* words, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if ((words[i] | words[i + 1] | words[i + 2] | words[i + 3]) != 0) {
+            break;
+        }
+    }
+    for (; i < n; ++i) {
+        if (words[i] != 0) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <WordOp Op>
+void CombineWordsScalar(uint64_t* dst, const uint64_t* src, size_t n) noexcept {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = ApplyWordOp<Op>(dst[i], src[i]);
+    }
+}
+
+#ifdef SIMPLE_VECTOR_SIMD_SSE2
+template <WordOp Op>
+void CombineWordsSse2(uint64_t* dst, const uint64_t* src, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128i lhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i rhs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i result;
+        if constexpr (Op == WordOp::kAnd) {
+            result = _mm_and_si128(lhs, rhs);
+        } else if constexpr (Op == WordOp::kOr) {
+            result = _mm_or_si128(lhs, rhs);
+        } else if constexpr (Op == WordOp::kXor) {
+            result = _mm_xor_si128(lhs, rhs);
+        } else {
+            result = _mm_andnot_si128(rhs, lhs);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+    CombineWordsScalar<Op>(dst + i, src + i, n - i);
+}
+#endif
+
+#ifdef SIMPLE_VECTOR_SIMD_AVX2
+template <WordOp Op>
+SIMPLE_VECTOR_TARGET_AVX2 void CombineWordsAvx2(uint64_t* dst, const uint64_t* src, size_t n) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i lhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i rhs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i result;
+        if constexpr (Op == WordOp::kAnd) {
+            result = _mm256_and_si256(lhs, rhs);
+        } else if constexpr (Op == WordOp::kOr) {
+            result = _mm256_or_si256(lhs, rhs);
+        } else if constexpr (Op == WordOp::kXor) {
+            result = _mm256_xor_si256(lhs, rhs);
+        } else {
+            result = _mm256_andnot_si256(rhs, lhs);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+    }
+    CombineWordsScalar<Op>(dst + i, src + i, n - i);
+}
+
+// Без -mpopcnt __builtin_popcountll раскрывается в последовательность сдвигов и масок,
+// а в обёртке с target("popcnt") — в одну инструкцию popcnt на слово
+__attribute__((target("popcnt"), flatten)) inline size_t PopCountWordsPopcnt(const uint64_t* words, size_t n) noexcept {
+    return PopCountWordsScalar(words, n);
+}
+
+inline bool HasPopcnt() noexcept {
+    static const bool has_popcnt = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt") != 0;
+    }();
+    return has_popcnt;
+}
+#endif
+
+}  // namespace detail
+
+// Сообщает, есть ли для типа Type векторизованные ядра
+template <typename Type>
+inline constexpr bool kHasKernels = !std::is_void_v<detail::Lane<Type>>;
+
+// Возвращает индекс первой пары неравных элементов lhs[i] и rhs[i] или n, если их нет
+template <typename Type>
+size_t FindFirstMismatch(const Type* lhs, const Type* rhs, size_t n) {
+    if constexpr (kHasKernels<Type>) {
+#if defined(SIMPLE_VECTOR_SIMD_AVX2)
+        if (detail::HasAvx2()) {
+            return detail::MismatchAvx2(lhs, rhs, n);
+        }
+        return detail::MismatchBlocks<detail::Sse2>(lhs, rhs, n);
+#elif defined(SIMPLE_VECTOR_SIMD_SSE2)
+        return detail::MismatchBlocks<detail::Sse2>(lhs, rhs, n);
+#elif defined(SIMPLE_VECTOR_SIMD_NEON)
+        return detail::MismatchBlocks<detail::Neon>(lhs, rhs, n);
+#endif
+    }
+    return static_cast<size_t>(std::mismatch(lhs, lhs + n, rhs).first - lhs);
+}
+
+// Возвращает индекс первого элемента, равного value, или n, если такого нет
+template <typename Type>
+size_t Find(const Type* data, size_t n, const Type& value) {
+    if constexpr (kHasKernels<Type>) {
+#if defined(SIMPLE_VECTOR_SIMD_AVX2)
+        if (detail::HasAvx2()) {
+            return detail::FindAvx2(data, n, value);
+        }
+        return detail::FindBlocks<detail::Sse2>(data, n, value);
+#elif defined(SIMPLE_VECTOR_SIMD_SSE2)
+        return detail::FindBlocks<detail::Sse2>(data, n, value);
+#elif defined(SIMPLE_VECTOR_SIMD_NEON)
+        return detail::FindBlocks<detail::Neon>(data, n, value);
+#endif
+    }
+    return static_cast<size_t>(std::find(data, data + n, value) - data);
+}
+
+// Возвращает число элементов, равных value
+template <typename Type>
+size_t Count(const Type* data, size_t n, const Type& value) {
+    if constexpr (kHasKernels<Type>) {
+#if defined(SIMPLE_VECTOR_SIMD_AVX2)
+        if (detail::HasAvx2()) {
+            return detail::CountAvx2(data, n, value);
+        }
+        return detail::CountBlocks<detail::Sse2>(data, n, value);
+#elif defined(SIMPLE_VECTOR_SIMD_SSE2)
+        return detail::CountBlocks<detail::Sse2>(data, n, value);
+#elif defined(SIMPLE_VECTOR_SIMD_NEON)
+        return detail::CountBlocks<detail::Neon>(data, n, value);
+#endif
+    }
+    return static_cast<size_t>(std::count(data, data + n, value));
+}
+
+// Сравнивает массивы поэлементно, как std::equal
+template <typename Type>
+bool Equal(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    return lhs_size == rhs_size && FindFirstMismatch(lhs, rhs, lhs_size) == lhs_size;
+}
+
+// Сравнивает массивы лексикографически, как std::lexicographical_compare.
+// В отличие от него, требует от Type и operator==, и operator<
+template <typename Type>
+bool LexicographicalLess(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+    const size_t common = std::min(lhs_size, rhs_size);
+    size_t offset = 0;
+    while (true) {
+        const size_t i = offset + FindFirstMismatch(lhs + offset, rhs + offset, common - offset);
+        if (i == common) {
+            return lhs_size < rhs_size;
+        }
+        if (lhs[i] < rhs[i]) {
+            return true;
+        }
+        if (rhs[i] < lhs[i]) {
+            return false;
+        }
+        // Неравные, но несравнимые значения (NaN) не решают исход сравнения
+        offset = i + 1;
+    }
+}
+
+
+// Возвращает число единичных битов в n словах words
+inline size_t PopCountWords(const uint64_t* words, size_t n) noexcept {
+#if defined(SIMPLE_VECTOR_SIMD_AVX2)
+    if (detail::HasPopcnt()) {
+        return detail::PopCountWordsPopcnt(words, n);
+    }
+#endif
+    return detail::PopCountWordsScalar(words, n);
+}
+
+// Возвращает индекс первого ненулевого из n слов words или n, если все нулевые
+inline size_t FindNonZeroWord(const uint64_t* words, size_t n) noexcept {
+    return detail::FindNonZeroWordScalar(words, n);
+}
+
+// Заменяет каждое dst[i] результатом операции Op над dst[i] и src[i]
+template <detail::WordOp Op>
+void CombineWords(uint64_t* dst, const uint64_t* src, size_t n) noexcept {
+#if defined(SIMPLE_VECTOR_SIMD_AVX2)
+    if (detail::HasAvx2()) {
+        detail::CombineWordsAvx2<Op>(dst, src, n);
+        return;
+    }
+    detail::CombineWordsSse2<Op>(dst, src, n);
+#elif defined(SIMPLE_VECTOR_SIMD_SSE2)
+    detail::CombineWordsSse2<Op>(dst, src, n);
+#else
+    detail::CombineWordsScalar<Op>(dst, src, n);
+#endif
+}
+
+}  // namespace simd
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+#include "simd_kernels.h"
+#include "simple_vector.h"
+
+// Невладеющее представление непрерывной последовательности элементов: указатель и размер.
+// Копируется за O(1) и не продлевает жизнь элементов, поэтому SimpleSpan нельзя хранить
+// дольше вектора, на который он ссылается, и после изменения его вместимости.
+// SimpleSpan<const Type> только читает элементы, SimpleSpan<Type> может их изменять.
+// Неявно строится из SimpleVector и (в C++20) из std::span, а также приводится к std::span
+template <typename Type>
+class SimpleSpan {
+    using Iterator = Type*;
+    using ValueType = std::remove_const_t<Type>;
+
+    // Разрешает преобразования, которые только добавляют const, как std::span
+    template <typename Other>
+    static constexpr bool kIsCompatible = std::is_convertible_v<Other (*)[], Type (*)[]>;
+
+public:
+
+    // Значение count, означающее «до конца последовательности»
+    static constexpr size_t kToEnd = std::numeric_limits<size_t>::max();
+
+    SimpleSpan() noexcept = default;
+
+    SimpleSpan(Type* data, size_t size) noexcept
+            : data_(data)
+            , size_(size) {
+    }
+
+    // Last — шаблонный параметр, чтобы SimpleSpan(data, 0) не был неоднозначен
+    template <typename Last, typename = std::enable_if_t<std::is_same_v<Last, Type*>>>
+    SimpleSpan(Type* first, Last last) noexcept
+            : data_(first)
+            , size_(last - first) {
+    }
+
+    template <typename Other, typename = std::enable_if_t<kIsCompatible<Other>>>
+    SimpleSpan(const SimpleSpan<Other>& other) noexcept
+            : data_(other.begin())
+            , size_(other.GetSize()) {
+    }
+
+    template <typename Other, typename Allocator, typename GrowthPolicy, typename = std::enable_if_t<kIsCompatible<Other>>>
+    SimpleSpan(SimpleVector<Other, Allocator, GrowthPolicy>& vector) noexcept
+            : data_(vector.Data())
+            , size_(vector.GetSize()) {
+    }
+
+    template <typename Other, typename Allocator, typename GrowthPolicy,
+              typename = std::enable_if_t<kIsCompatible<const Other>>>
+    SimpleSpan(const SimpleVector<Other, Allocator, GrowthPolicy>& vector) noexcept
+            : data_(vector.Data())
+            , size_(vector.GetSize()) {
+    }
+
+#if __cpp_lib_span >= 202002L
+    template <typename Other, size_t Extent, typename = std::enable_if_t<kIsCompatible<Other>>>
+    SimpleSpan(std::span<Other, Extent> span) noexcept
+            : data_(span.data())
+            , size_(span.size()) {
+    }
+
+    operator std::span<Type>() const noexcept {
+        return {data_, size_};
+    }
+#endif
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    Type* Data() const noexcept {
+        return data_;
+    }
+
+    Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index или бросает std::out_of_range
+    Type& At(size_t index) const {
+        if (index >= size_) {
+            throw std::out_of_range("Index out of range");
+        }
+        return data_[index];
+    }
+
+    // Возвращает count элементов, начиная с offset, или все элементы от offset до конца.
+    // offset не должен превышать размер, а offset + count — выходить за конец
+    SimpleSpan Subspan(size_t offset, size_t count = kToEnd) const noexcept {
+        assert(offset <= size_);
+        if (count == kToEnd) {
+            count = size_ - offset;
+        }
+        assert(count <= size_ - offset);
+        return {data_ + offset, count};
+    }
+
+    // Возвращает первые count элементов
+    SimpleSpan First(size_t count) const noexcept {
+        assert(count <= size_);
+        return {data_, count};
+    }
+
+    // Возвращает последние count элементов
+    SimpleSpan Last(size_t count) const noexcept {
+        assert(count <= size_);
+        return {data_ + (size_ - count), count};
+    }
+
+    // Возвращает итератор на первый элемент, равный value, или end()
+    Iterator Find(const ValueType& value) const noexcept(simd::kHasKernels<ValueType>) {
+        return data_ + simd::Find<ValueType>(data_, size_, value);
+    }
+
+    bool Contains(const ValueType& value) const noexcept(simd::kHasKernels<ValueType>) {
+        return Find(value) != end();
+    }
+
+    // Возвращает число элементов, равных value
+    size_t Count(const ValueType& value) const noexcept(simd::kHasKernels<ValueType>) {
+        return simd::Count<ValueType>(data_, size_, value);
+    }
+
+    Iterator begin() const noexcept {
+        return data_;
+    }
+
+    Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    Iterator cbegin() const noexcept {
+        return data_;
+    }
+
+    Iterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SimpleSpan(SimpleVector<Type, Allocator, GrowthPolicy>&) -> SimpleSpan<Type>;
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+SimpleSpan(const SimpleVector<Type, Allocator, GrowthPolicy>&) -> SimpleSpan<const Type>;
+
+// Сравнения SimpleSpan между собой и с SimpleVector того же типа элементов.
+// Как и у SimpleVector, элементы арифметических типов сравниваются векторизованно
+
+template <typename Sequence>
+struct SpanElement {
+    using type = void;
+};
+
+template <typename Type>
+struct SpanElement<SimpleSpan<Type>> {
+    using type = std::remove_const_t<Type>;
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+struct SpanElement<SimpleVector<Type, Allocator, GrowthPolicy>> {
+    using type = Type;
+};
+
+template <typename Sequence>
+inline constexpr bool kIsSimpleSpan = false;
+
+template <typename Type>
+inline constexpr bool kIsSimpleSpan<SimpleSpan<Type>> = true;
+
+// Истинно, если хотя бы один операнд — SimpleSpan, а другой — SimpleSpan или SimpleVector
+// с тем же типом элементов. Сравнения двух SimpleVector остаются в simple_vector.h
+template <typename Lhs, typename Rhs>
+inline constexpr bool kIsSpanComparison = (kIsSimpleSpan<Lhs> || kIsSimpleSpan<Rhs>)
+        && !std::is_void_v<typename SpanElement<Lhs>::type>
+        && std::is_same_v<typename SpanElement<Lhs>::type, typename SpanElement<Rhs>::type>;
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator==(const Lhs& lhs, const Rhs& rhs) {
+    return simd::Equal(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator!=(const Lhs& lhs, const Rhs& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator<(const Lhs& lhs, const Rhs& rhs) {
+    if constexpr (simd::kHasKernels<typename SpanElement<Lhs>::type>) {
+        return simd::LexicographicalLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+    } else {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator>(const Lhs& lhs, const Rhs& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator<=(const Lhs& lhs, const Rhs& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Lhs, typename Rhs, typename = std::enable_if_t<kIsSpanComparison<Lhs, Rhs>>>
+bool operator>=(const Lhs& lhs, const Rhs& rhs) {
+    return !(lhs < rhs);
+}
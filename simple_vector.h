@@ -1,32 +1,84 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <functional>
+#include <type_traits>
 
-#include "array_ptr.h"
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#endif
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+#include "simd_kernels.h"
+#include "vector_checks.h"
+#include "vector_constexpr.h"
+#include "vector_stats.h"
 
 struct ReserveProxyObj {
     size_t value = 0;
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+// constexpr-функция неявно inline и не нарушает ODR при подключении из нескольких единиц трансляции
+constexpr ReserveProxyObj Reserve(size_t capacity_to_reserve) noexcept {
     return { capacity_to_reserve };
 }
 
-template <typename Type>
+// Сообщают, является ли It итератором ввода (однопроходным) или однонаправленным
+// итератором. Нужны, чтобы отличать Insert(pos, first, last) от Insert(pos, count, value)
+template <typename It, typename = void>
+inline constexpr bool kIsInputIterator = false;
+
+template <typename It>
+inline constexpr bool kIsInputIterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>> =
+        std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag>;
+
+template <typename It, typename = void>
+inline constexpr bool kIsForwardIterator = false;
+
+template <typename It>
+inline constexpr bool kIsForwardIterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>> =
+        std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// GrowthPolicy задаёт, во сколько раз растёт вместимость при заполнении (см. growth_policy.h).
+// В C++20 конструирование, доступ к элементам, PushBack, Reserve и Resize доступны
+// в константных выражениях (см. vector_constexpr.h)
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
 class SimpleVector {
 
+    // В проверяемом режиме (см. vector_checks.h) итераторы проверяют себя при разыменовании
+#ifdef SIMPLE_VECTOR_CHECKED
+    using Iterator = CheckedIterator<Type>;
+    using ConstIterator = CheckedIterator<const Type>;
+#else
     using Iterator = Type*;
     using ConstIterator = const Type*;
+#endif
+    using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    // Перемещающее присваивание забирает буфер, не выделяя памяти
+    static constexpr bool kNothrowMoveAssign = AllocatorTraits::propagate_on_container_move_assignment::value
+                                               || AllocatorTraits::is_always_equal::value;
 
 public:
 
-    SimpleVector() noexcept = default;
+    using allocator_type = Allocator;
 
-    SimpleVector(const ReserveProxyObj& reserve_obj) : SimpleVector() {
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector() noexcept = default;
+
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Allocator& allocator) noexcept : data_(allocator) {
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const ReserveProxyObj& reserve_obj, const Allocator& allocator = Allocator())
+            : SimpleVector(allocator) {
         size_t capacity = reserve_obj.value;
         if (capacity == 0) {
             return;
@@ -35,65 +87,126 @@ public:
     }
 
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size) {
-        ArrayPtr<Type> temp(size);
-        data_.swap(temp);
-        size_ = capacity_ = size;
+    SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(size_t size, const Allocator& allocator = Allocator()) : data_(size, allocator) {
+        data_.ConstructN(data_.Get(), size);
+        size_ = size;
     }
 
     // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value) : SimpleVector(size) {
-        std::fill(begin(), end(), value);
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type& value, const Allocator& allocator = Allocator())
+            : data_(size, allocator) {
+        data_.ConstructN(data_.Get(), size, value);
+        size_ = size;
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init) : SimpleVector(init.size()) {
-        std::copy(init.begin(), init.end(), begin());
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Allocator& allocator = Allocator())
+            : data_(init.size(), allocator) {
+        data_.CopyConstructN(init.begin(), init.size(), data_.Get());
+        size_ = init.size();
+    }
+
+    // Создаёт вектор из элементов диапазона [first, last)
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    SimpleVector(InputIt first, InputIt last, const Allocator& allocator = Allocator())
+            : SimpleVector(allocator) {
+        Assign(first, last);
+    }
+
+    //Конструктор копирования. Аллокатор выбирается через select_on_container_copy_construction
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other)
+            : SimpleVector(other, AllocatorTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+    }
+
+    //Конструктор копирования с заданным аллокатором
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other, const Allocator& allocator) : data_(other.size_, allocator) {
+        data_.CopyConstructN(other.data_.Get(), other.size_, data_.Get());
+        size_ = other.size_;
+    }
+
+    //Конструктор перемещения. Аллокатор перемещается вместе с буфером. Не бросает
+    //исключений, поэтому std::vector<SimpleVector> при росте перемещает элементы, а не копирует
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other) noexcept
+            : data_(std::move(other.data_))
+            , size_(std::exchange(other.size_, 0))
+            , growth_hint_(other.growth_hint_) {
+        other.generation_.Advance();
+    }
+
+    //Конструктор перемещения с заданным аллокатором. Если аллокаторы не равны,
+    //элементы перемещаются по одному в новый буфер
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other, const Allocator& allocator) : data_(allocator) {
+        if (data_.GetAllocator() == other.data_.GetAllocator()) {
+            data_ = std::move(other.data_);
+            size_ = std::exchange(other.size_, 0);
+            other.generation_.Advance();
+        } else {
+            RawMemory<Type, Allocator> new_data(other.size_, allocator);
+            new_data.MoveOrCopyConstructN(other.data_.Get(), other.size_, new_data.Get());
+            data_.swap(new_data);
+            size_ = other.size_;
+            other.Clear();
+        }
     }
 
-    //Конструктор копирования
-    SimpleVector(const SimpleVector& other) {
-        CopyAndSwap(other);
+    // Не бросает исключений, если аллокатор передаётся при перемещении или все его
+    // экземпляры равны. Самоприсваивание ничего не меняет
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(SimpleVector&& other) noexcept(kNothrowMoveAssign) {
+        MoveFrom(other);
+        return *this;
     }
 
-    //Конструктор перемещения
-    SimpleVector(SimpleVector&& other) {
-        MoveFrom(other);
+    SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+        data_.DestroyN(data_.Get(), size_);
     }
 
-    SimpleVector& operator=(SimpleVector&& other) {
-        MoveFrom(other);
-        return *this;
+    // Возвращает копию аллокатора
+    SIMPLE_VECTOR_CONSTEXPR Allocator GetAllocator() const noexcept {
+        return data_.GetAllocator();
     }
 
     // Возвращает количество элементов в массиве
-    size_t GetSize() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
         return size_;
     }
 
     // Возвращает вместимость массива
-    size_t GetCapacity() const noexcept {
-        return capacity_;
+    SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
+        return data_.Capacity();
     }
 
     // Сообщает, пустой ли массив
-    bool IsEmpty() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
         return size_ == 0;
     }
 
+    // Сообщает ожидаемый итоговый размер массива. При следующем росте вместимость
+    // сразу станет не меньше expected_size, что избавляет от промежуточных
+    // перераспределений. Подсказка 0 отключает эффект
+    SIMPLE_VECTOR_CONSTEXPR void SetGrowthHint(size_t expected_size) noexcept {
+        growth_hint_ = expected_size;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GetGrowthHint() const noexcept {
+        return growth_hint_;
+    }
+
     // Возвращает ссылку на элемент с индексом index
-    Type& operator[](size_t index) noexcept {
+    // В проверяемом режиме index >= size считается ошибкой
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
         return data_[index];
     }
 
     // Возвращает константную ссылку на элемент с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
         return data_[index];
     }
 
     // Возвращает ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    Type& At(size_t index) {
+    SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
         return const_cast<Type&>(
                 const_cast<const SimpleVector*>(this)->At(index)
         );
@@ -101,7 +214,7 @@ public:
 
     // Возвращает константную ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    const Type& At(size_t index) const {
+    SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
         using namespace std::literals;
         if (index >= size_) {
             throw std::out_of_range("out of range"s);
@@ -110,196 +223,631 @@ public:
         return data_[index];
     }
 
+    // Возвращает указатель на первый элемент. Для пустого массива может быть равен nullptr
+    SIMPLE_VECTOR_CONSTEXPR Type* Data() noexcept {
+        return data_.Get();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* Data() const noexcept {
+        return data_.Get();
+    }
+
+    // Возвращает итератор на первый элемент, равный value, или end(), если такого нет.
+    // Для арифметических типов поиск векторизован (см. simd_kernels.h)
+    Iterator Find(const Type& value) noexcept(simd::kHasKernels<Type>) {
+        return begin() + simd::Find(data_.Get(), size_, value);
+    }
+
+    ConstIterator Find(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return cbegin() + simd::Find(data_.Get(), size_, value);
+    }
+
+    bool Contains(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return Find(value) != cend();
+    }
+
+    // Возвращает число элементов, равных value
+    size_t Count(const Type& value) const noexcept(simd::kHasKernels<Type>) {
+        return simd::Count(data_.Get(), size_, value);
+    }
+
     // Обнуляет размер массива, не изменяя его вместимость
-    void Clear() noexcept {
+    SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+        data_.DestroyN(data_.Get(), size_);
         size_ = 0;
     }
 
     // Изменяет размер массива.
-    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
-    void Resize(const size_t new_size) {
-        //new_size меньше или равен вместимости capacity_, но больше, чем size_
-        if (new_size > size_ && new_size <= capacity_) {
-            std::fill(end(), begin() + new_size, Type{});
-        } else { //Превышает вместимость
-            Reserve(new_size);
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type.
+    // Вместимость растёт по политике роста, поэтому Resize по одному элементу
+    // выполняется за амортизированное O(1)
+    SIMPLE_VECTOR_CONSTEXPR void Resize(const size_t new_size) {
+        if (new_size < size_) {
+            data_.DestroyN(data_ + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            if (new_size > GetCapacity()) {
+                Reserve(GrownCapacity(new_size));
+            }
+            data_.ConstructN(data_ + size_, new_size - size_);
         }
         size_ = new_size;
     }
 
-    void Reserve(size_t new_capacity) {
-        if (capacity_ != 0 && capacity_ >= new_capacity) {
+    // Уменьшает вместимость до размера массива, если неиспользуемые ячейки
+    // составляют больше доли unused_threshold вместимости. При пороге 0 лишняя
+    // память освобождается всегда, пустой массив отдаёт буфер целиком
+    void ShrinkToFit(double unused_threshold = 0.0) {
+        const size_t unused = GetCapacity() - size_;
+        if (unused == 0 || static_cast<double>(unused) <= unused_threshold * static_cast<double>(GetCapacity())) {
             return;
         }
-        new_capacity = std::max(new_capacity, size_t(1));
-        ArrayPtr<Type> temp(new_capacity);
-        std::copy(std::make_move_iterator(begin()), std::make_move_iterator(end()), temp.Get());
-        data_.swap(temp);
-        capacity_ = new_capacity;
+        if constexpr (RawMemory<Type, Allocator>::kCanReallocate) {
+            data_.Reallocate(size_);
+        } else {
+            RawMemory<Type, Allocator> new_data(size_, data_.GetAllocator());
+            data_.RelocateN(data_.Get(), size_, new_data.Get());
+            data_.swap(new_data);
+        }
+        generation_.Advance();
     }
 
-    void PushBack(const Type& value) {
-        if (size_ == capacity_) {
-            Reserve(capacity_ * 2);
+    // Увеличивает вместимость до new_capacity. При перевыделении буфера
+    // итераторы, указатели и ссылки на элементы становятся недействительными
+    SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
+        if (GetCapacity() != 0 && GetCapacity() >= new_capacity) {
+            return;
         }
-        data_[size_] = value;
-        ++size_;
+        new_capacity = std::max(new_capacity, size_t(1));
+        RecordRegrowth<Type>(new_capacity);
+        if constexpr (RawMemory<Type, Allocator>::kCanReallocate) {
+            // realloc недоступен в константных выражениях
+            if (!IsConstantEvaluated()) {
+                data_.Reallocate(new_capacity);
+                generation_.Advance();
+                return;
+            }
+        }
+        RawMemory<Type, Allocator> new_data(new_capacity, data_.GetAllocator());
+        data_.RelocateN(data_.Get(), size_, new_data.Get());
+        data_.swap(new_data);
+        generation_.Advance();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type& value) {
+        EmplaceBack(value);
     }
 
     //Перемещающий push_back
-    void PushBack(Type&& value) {
-        if (size_ == capacity_) {
-            Reserve(capacity_ * 2);
-        }
-        data_[size_] = std::move(value);
-        ++size_;
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
     }
 
     Iterator Insert(ConstIterator pos, const Type& value) {
-        int offset = pos - begin();
-        Iterator true_position = begin() + offset;
-        if (size_ == capacity_) {
-            Reserve(capacity_ * 2);
-            true_position = begin() + offset;
-        }
-
-        std::move_backward(std::make_move_iterator(true_position), std::make_move_iterator(end()),
-                end() + 1);
-        *true_position = value;
-        ++size_;
-        return true_position;
+        return Emplace(pos, value);
     }
 
     //Перемещающий insert
     Iterator Insert(ConstIterator pos, Type&& value) {
-        int offset = pos - begin();
-        Iterator true_position = begin() + offset;
-        if (size_ == capacity_) {
-            Reserve(capacity_ * 2);
-            true_position = begin() + offset;
+        return Emplace(pos, std::move(value));
+    }
+
+    // Вставляет перед pos элементы диапазона [first, last) и возвращает итератор на первый
+    // из них. Память выделяется не более одного раза, хвост сдвигается один раз.
+    // Диапазон может принадлежать самому вектору
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        const size_t offset = OffsetOf(pos);
+        if constexpr (!kIsForwardIterator<InputIt>) {
+            // Длина однопроходного диапазона заранее неизвестна: дописываем в конец и поворачиваем
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(data_ + offset, data_ + old_size, data_ + size_);
+            return MakeIterator(data_ + offset);
+        } else {
+            if (PointsIntoSelf(first, last)) {
+                SimpleVector temp(first, last, data_.GetAllocator());
+                return Insert(pos, std::make_move_iterator(temp.begin()), std::make_move_iterator(temp.end()));
+            }
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            return InsertN(offset, count, [&](Type* to) {
+                data_.CopyConstructN(first, count, to);
+            });
+        }
+    }
+
+    // Вставляет перед pos count копий value и возвращает итератор на первую из них
+    Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
+        if (PointsIntoSelf(&value, &value + 1)) {
+            const SimpleVector temp(1, value, data_.GetAllocator());
+            return Insert(pos, count, temp[0]);
+        }
+        return InsertN(OffsetOf(pos), count, [&](Type* to) {
+            data_.ConstructN(to, count, value);
+        });
+    }
+
+    // Вставляет перед pos элементы списка init
+    Iterator Insert(ConstIterator pos, std::initializer_list<Type> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    // Дописывает в конец элементы диапазона [first, last)
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    void Append(InputIt first, InputIt last) {
+        Insert(cend(), first, last);
+    }
+
+    // Заменяет содержимое элементами диапазона [first, last). Имеющаяся
+    // вместимость используется повторно, если её достаточно
+    template <typename InputIt, typename = std::enable_if_t<kIsInputIterator<InputIt>>>
+    void Assign(InputIt first, InputIt last) {
+        if constexpr (!kIsForwardIterator<InputIt>) {
+            Clear();
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+        } else {
+            const size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count > GetCapacity() || PointsIntoSelf(first, last)) {
+                RawMemory<Type, Allocator> new_data(std::max(count, GetCapacity()), data_.GetAllocator());
+                new_data.CopyConstructN(first, count, new_data.Get());
+                Clear();
+                data_.swap(new_data);
+                generation_.Advance();
+            } else {
+                Clear();
+                data_.CopyConstructN(first, count, data_.Get());
+            }
+            size_ = count;
         }
+    }
+
+    // Заменяет содержимое count копиями value
+    void Assign(size_t count, const Type& value) {
+        if (count > GetCapacity() || PointsIntoSelf(&value, &value + 1)) {
+            RawMemory<Type, Allocator> new_data(std::max(count, GetCapacity()), data_.GetAllocator());
+            new_data.ConstructN(new_data.Get(), count, value);
+            Clear();
+            data_.swap(new_data);
+            generation_.Advance();
+        } else {
+            Clear();
+            data_.ConstructN(data_.Get(), count, value);
+        }
+        size_ = count;
+    }
+
+    // Заменяет содержимое элементами списка init
+    void Assign(std::initializer_list<Type> init) {
+        Assign(init.begin(), init.end());
+    }
 
-        std::move_backward(std::make_move_iterator(true_position), std::make_move_iterator(end()),
-                           end() + 1);
-        *true_position = std::move(value);
+    // Конструирует элемент в конце массива из аргументов args, возвращает ссылку на него
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            if (size_ == GetCapacity() && !IsConstantEvaluated()) {
+                return *Emplace(cend(), std::forward<Args>(args)...);
+            }
+        }
+        if (size_ == GetCapacity()) {
+            // Новый элемент создаётся до переноса старых, так как args могут ссылаться на один из них
+            RawMemory<Type, Allocator> new_data(GrownCapacity(size_ + 1), data_.GetAllocator());
+            RecordRegrowth<Type>(new_data.Capacity());
+            new_data.Construct(new_data + size_, std::forward<Args>(args)...);
+            try {
+                data_.RelocateN(data_.Get(), size_, new_data.Get());
+            } catch (...) {
+                new_data.Destroy(new_data + size_);
+                throw;
+            }
+            data_.swap(new_data);
+            generation_.Advance();
+        } else {
+            data_.Construct(data_ + size_, std::forward<Args>(args)...);
+        }
         ++size_;
-        return true_position;
+        return data_[size_ - 1];
+    }
+
+    // Конструирует элемент из аргументов args перед позицией pos, возвращает итератор на него
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = OffsetOf(pos);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            // args могут ссылаться на элемент вектора, поэтому объект создаётся во временной
+            // сырой ячейке до роста и сдвига, а затем переносится на место побайтово
+            alignas(Type) unsigned char temp[sizeof(Type)];
+            Type* temp_obj = reinterpret_cast<Type*>(temp);
+            data_.Construct(temp_obj, std::forward<Args>(args)...);
+            if (size_ == GetCapacity()) {
+                try {
+                    Reserve(GrownCapacity(size_ + 1));
+                } catch (...) {
+                    data_.Destroy(temp_obj);
+                    throw;
+                }
+            }
+            RecordMoves<Type>(size_ - offset);
+            RelocateOverlappingN(data_ + offset, size_ - offset, data_ + (offset + 1));
+            UninitializedRelocateN(temp_obj, 1, data_ + offset);
+        } else if (size_ == GetCapacity()) {
+            RawMemory<Type, Allocator> new_data(GrownCapacity(size_ + 1), data_.GetAllocator());
+            RecordRegrowth<Type>(new_data.Capacity());
+            new_data.Construct(new_data + offset, std::forward<Args>(args)...);
+            try {
+                new_data.MoveOrCopyConstructN(data_.Get(), offset, new_data.Get());
+            } catch (...) {
+                new_data.Destroy(new_data + offset);
+                throw;
+            }
+            try {
+                new_data.MoveOrCopyConstructN(data_ + offset, size_ - offset, new_data + (offset + 1));
+            } catch (...) {
+                new_data.DestroyN(new_data.Get(), offset + 1);
+                throw;
+            }
+            data_.DestroyN(data_.Get(), size_);
+            data_.swap(new_data);
+            generation_.Advance();
+        } else if (offset == size_) {
+            data_.Construct(data_ + size_, std::forward<Args>(args)...);
+        } else {
+            // args могут ссылаться на элемент вектора, поэтому объект создаём до сдвига
+            alignas(Type) unsigned char temp[sizeof(Type)];
+            Type* temp_obj = reinterpret_cast<Type*>(temp);
+            data_.Construct(temp_obj, std::forward<Args>(args)...);
+            RecordMoves<Type>(size_ - offset);
+            try {
+                data_.Construct(data_ + size_, std::move(*(data_ + (size_ - 1))));
+                // Новый последний элемент сразу входит в размер: если сдвиг бросит
+                // исключение, он будет разрушен вместе с остальными
+                ++size_;
+                std::move_backward(data_ + offset, data_ + (size_ - 2), data_ + (size_ - 1));
+                data_[offset] = std::move(*temp_obj);
+            } catch (...) {
+                data_.Destroy(temp_obj);
+                throw;
+            }
+            data_.Destroy(temp_obj);
+            return MakeIterator(data_ + offset);
+        }
+        ++size_;
+        return MakeIterator(data_ + offset);
     }
 
     Iterator Erase(ConstIterator pos) {
-        int offset = pos - begin();
-        Iterator true_position = begin() + offset;
-        std::move(std::make_move_iterator(true_position + 1), std::make_move_iterator(end()),
-                true_position);
+        const size_t offset = OffsetOf(pos);
+        SIMPLE_VECTOR_CHECK(offset < size_, "erasing the end iterator");
+        Type* true_position = data_ + offset;
+        RecordMoves<Type>(size_ - offset - 1);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            data_.Destroy(true_position);
+            RelocateOverlappingN(true_position + 1, size_ - offset - 1, true_position);
+        } else {
+            std::move(true_position + 1, data_ + size_, true_position);
+            data_.Destroy(data_ + (size_ - 1));
+        }
         --size_;
-        return true_position;
+        return MakeIterator(true_position);
+    }
+
+    // Удаляет элементы диапазона [first, last) за один сдвиг хвоста
+    // и возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t offset = OffsetOf(first);
+        const size_t last_offset = OffsetOf(last);
+        SIMPLE_VECTOR_CHECK(offset <= last_offset, "erasing a reversed range");
+        const size_t count = last_offset - offset;
+        Type* true_first = data_ + offset;
+        if (count == 0) {
+            return MakeIterator(true_first);
+        }
+        RecordMoves<Type>(size_ - offset - count);
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            data_.DestroyN(true_first, count);
+            RelocateOverlappingN(true_first + count, size_ - offset - count, true_first);
+        } else {
+            Type* new_end = std::move(true_first + count, data_ + size_, true_first);
+            data_.DestroyN(new_end, count);
+        }
+        size_ -= count;
+        return MakeIterator(true_first);
     }
 
-    void PopBack() noexcept {
-        size_ = size_ > 0 ? size_ - 1 : 0;
+    SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
+        if (size_ > 0) {
+            data_.Destroy(data_ + (size_ - 1));
+            --size_;
+        }
     }
 
     // Возвращает итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator begin() noexcept {
-        return data_.Get();
+    SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
+        return MakeIterator(data_.Get());
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator end() noexcept {
-        return data_.Get() + size_;
+    SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
+        return MakeIterator(data_ + size_);
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator begin() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
         return cbegin();
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator end() const noexcept {
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
         return cend();
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cbegin() const noexcept {
-        return data_.Get();
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
+        return MakeIterator(data_.Get());
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cend() const noexcept {
-        return data_.Get() + size_;
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
+        return MakeIterator(data_ + size_);
     }
 
-    SimpleVector& operator=(const SimpleVector& other) {
-        CopyAndSwap(other);
+    // Если вместимости хватает и аллокатор не меняется, буфер используется повторно.
+    // Как и у std::vector, при исключении во время копирования вектор остаётся
+    // корректным, но может содержать часть новых элементов
+    SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(const SimpleVector& other) {
+        if (this != &other) {
+            CopyFrom(other);
+        }
         return *this;
     }
 
-    void swap(SimpleVector& other) noexcept {
+    // Обменивается содержимым с other. Аллокаторы обмениваются по правилам
+    // propagate_on_container_swap, иначе они должны быть равны.
+    // Проверяемый режим считает итераторы обоих векторов недействительными после обмена
+    SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector& other) noexcept {
         data_.swap(other.data_);
         std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
+        std::swap(growth_hint_, other.growth_hint_);
+        generation_.Advance();
+        other.generation_.Advance();
     }
 
 private:
 
-    //Сам массив
-    ArrayPtr<Type> data_ = {};
+    //Сырая память под элементы. Сконструированы только первые size_ ячеек
+    RawMemory<Type, Allocator> data_ = {};
 
     //Размер массива
     size_t size_ = 0;
 
-    //Вместимость массива
-    size_t capacity_ = 0;
-
-    void CopyAndSwap(const SimpleVector& other) {
-        size_t size = other.size_;
-        ArrayPtr<Type> temp(size);
-        std::copy(other.begin(), other.end(), temp.Get());
-        data_.swap(temp);
-        size_ = capacity_ = size;
+    //Ожидаемый итоговый размер, заданный через SetGrowthHint
+    size_t growth_hint_ = 0;
+
+    //Число перевыделений буфера, по которому проверяемые итераторы узнают об устаревании
+    [[no_unique_address]] VectorGeneration generation_ = {};
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator MakeIterator(Type* ptr) noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        return Iterator(ptr, data_.Get(), &size_, &generation_.value);
+#else
+        return ptr;
+#endif
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator MakeIterator(const Type* ptr) const noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        return ConstIterator(ptr, data_.Get(), &size_, &generation_.value);
+#else
+        return ptr;
+#endif
+    }
+
+    // Возвращает смещение pos от начала массива. В проверяемом режиме pos должен
+    // быть действительным итератором этого вектора из диапазона [begin(), end()]
+    size_t OffsetOf(ConstIterator pos) const {
+#ifdef SIMPLE_VECTOR_CHECKED
+        SIMPLE_VECTOR_CHECK(pos.IsCurrent(&generation_.value), "iterator of another vector or invalidated by reallocation");
+        SIMPLE_VECTOR_CHECK(data_.Get() <= pos.Base() && pos.Base() <= data_ + size_, "iterator out of range");
+        return static_cast<size_t>(pos.Base() - data_.Get());
+#else
+        return static_cast<size_t>(pos - data_.Get());
+#endif
+    }
+
+    // Копирует элементы other с аллокатором *this, а при propagate_on_container_copy_assignment
+    // аллокатор предварительно заменяется аллокатором other. Если элементы other помещаются
+    // в буфер, общим элементам присваиваются значения, недостающие конструируются,
+    // а лишние разрушаются. Иначе копия строится в новом буфере и обменивается с текущим
+    SIMPLE_VECTOR_CONSTEXPR void CopyFrom(const SimpleVector& other) {
+        if constexpr (AllocatorTraits::propagate_on_container_copy_assignment::value) {
+            if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                Clear();
+                data_.Reset(other.data_.GetAllocator());
+            }
+        }
+        if (other.size_ > GetCapacity()) {
+            SimpleVector temp(other, data_.GetAllocator());
+            swap(temp);
+            return;
+        }
+        // Тривиально копируемые элементы не присваиваются, а конструируются заново:
+        // их разрушение ничего не стоит, а CopyConstructN копирует большие буферы параллельно
+        size_t assigned = 0;
+        if constexpr (std::is_copy_assignable_v<Type> && !std::is_trivially_copyable_v<Type>) {
+            assigned = std::min(size_, other.size_);
+            RecordCopies<Type>(assigned);
+            std::copy_n(other.data_.Get(), assigned, data_.Get());
+        }
+        if (size_ > assigned) {
+            data_.DestroyN(data_ + assigned, size_ - assigned);
+            size_ = assigned;
+        }
+        data_.CopyConstructN(other.data_ + size_, other.size_ - size_, data_ + size_);
+        size_ = other.size_;
     }
 
-    void MoveFrom(SimpleVector& other) {
+    // Забирает буфер other, если аллокатор можно передать или аллокаторы равны.
+    // Иначе элементы перемещаются по одному в память, выделенную аллокатором *this
+    SIMPLE_VECTOR_CONSTEXPR void MoveFrom(SimpleVector& other) noexcept(kNothrowMoveAssign) {
+        if (this == &other) {
+            return;
+        }
+        if constexpr (!AllocatorTraits::propagate_on_container_move_assignment::value
+                      && !AllocatorTraits::is_always_equal::value) {
+            if (data_.GetAllocator() != other.data_.GetAllocator()) {
+                SimpleVector temp(std::move(other), data_.GetAllocator());
+                swap(temp);
+                return;
+            }
+        }
+        Clear();
         data_ = std::move(other.data_);
         size_ = std::exchange(other.size_, 0);
-        capacity_ = std::exchange(other.capacity_, 0);
+        generation_.Advance();
+        other.generation_.Advance();
+    }
+
+    // Сообщает, указывает ли диапазон [first, last) внутрь собственных элементов
+    template <typename It>
+    bool PointsIntoSelf(It first, It last) const noexcept {
+        if constexpr (kVectorChecked && (std::is_same_v<It, Iterator> || std::is_same_v<It, ConstIterator>)) {
+            return PointsIntoSelf(first.Base(), last.Base());
+        } else if constexpr (std::is_pointer_v<It>
+                      && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<It>>, Type>) {
+            const std::less<const Type*> less;
+            return first != last && less(first, data_ + size_) && !less(last, data_ + 1);
+        } else {
+            return false;
+        }
+    }
+
+    // Вставляет count элементов, начиная с позиции offset. construct(to) должен
+    // сконструировать их в неинициализированной памяти to, а при исключении
+    // разрушить уже созданные. Источник не должен ссылаться на элементы вектора
+    template <typename ConstructFn>
+    Iterator InsertN(size_t offset, size_t count, ConstructFn construct) {
+        if (count == 0) {
+            return MakeIterator(data_ + offset);
+        }
+        if (size_ + count > GetCapacity()) {
+            if constexpr (RawMemory<Type, Allocator>::kCanReallocate) {
+                Reserve(GrownCapacity(size_ + count));
+            } else {
+                RawMemory<Type, Allocator> new_data(GrownCapacity(size_ + count), data_.GetAllocator());
+                RecordRegrowth<Type>(new_data.Capacity());
+                construct(new_data + offset);
+                if constexpr (kIsTriviallyRelocatable<Type>) {
+                    UninitializedRelocateN(data_.Get(), offset, new_data.Get());
+                    UninitializedRelocateN(data_ + offset, size_ - offset, new_data + (offset + count));
+                } else {
+                    try {
+                        new_data.MoveOrCopyConstructN(data_.Get(), offset, new_data.Get());
+                    } catch (...) {
+                        new_data.DestroyN(new_data + offset, count);
+                        throw;
+                    }
+                    try {
+                        new_data.MoveOrCopyConstructN(data_ + offset, size_ - offset, new_data + (offset + count));
+                    } catch (...) {
+                        new_data.DestroyN(new_data.Get(), offset + count);
+                        throw;
+                    }
+                    data_.DestroyN(data_.Get(), size_);
+                }
+                data_.swap(new_data);
+                generation_.Advance();
+                size_ += count;
+                return MakeIterator(data_ + offset);
+            }
+        }
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            // Хвост сдвигается побайтово один раз, новые элементы создаются в образовавшемся разрыве
+            RecordMoves<Type>(size_ - offset);
+            RelocateOverlappingN(data_ + offset, size_ - offset, data_ + (offset + count));
+            try {
+                construct(data_ + offset);
+            } catch (...) {
+                RelocateOverlappingN(data_ + (offset + count), size_ - offset, data_ + offset);
+                throw;
+            }
+            size_ += count;
+        } else {
+            construct(data_ + size_);
+            RecordMoves<Type>(size_ - offset);
+            // Новые элементы сразу входят в размер: если поворот бросит
+            // исключение, они будут разрушены вместе с остальными
+            size_ += count;
+            std::rotate(data_ + offset, data_ + (size_ - count), data_ + size_);
+        }
+        return MakeIterator(data_ + offset);
+    }
+
+    // Вместимость после роста, когда в массиве должно поместиться required элементов
+    SIMPLE_VECTOR_CONSTEXPR size_t GrownCapacity(size_t required) const noexcept {
+        const size_t capacity = GrowthPolicy::NextCapacity(GetCapacity(), required, sizeof(Type));
+        return std::max({capacity, required, growth_hint_});
     }
 
 };
 
+// Удаляет из вектора все элементы, для которых pred возвращает true, за один
+// линейный проход и возвращает количество удалённых элементов
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Predicate>
+size_t EraseIf(SimpleVector<Type, Allocator, GrowthPolicy>& vector, Predicate pred) {
+    auto new_end = std::remove_if(vector.begin(), vector.end(), pred);
+    const size_t removed = vector.end() - new_end;
+    vector.Erase(new_end, vector.end());
+    return removed;
+}
+
+#if __has_include(<memory_resource>)
+// SimpleVector, получающий память у std::pmr::memory_resource, например у арены
+// std::pmr::monotonic_buffer_resource
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+using PmrSimpleVector = SimpleVector<Type, std::pmr::polymorphic_allocator<Type>, GrowthPolicy>;
+#endif
 
-template <typename Type>
-bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    // Для арифметических типов сравнение векторизовано (см. simd_kernels.h)
+    return simd::Equal(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
 }
 
-template <typename Type>
-bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Type>
-bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    if constexpr (simd::kHasKernels<Type>) {
+        return simd::LexicographicalLess(lhs.Data(), lhs.GetSize(), rhs.Data(), rhs.GetSize());
+    } else {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
 }
 
-template <typename Type>
-bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return rhs < lhs;
 }
 
-template <typename Type>
-bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs > rhs);
 }
 
-template <typename Type>
-bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs, const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(rhs > lhs);
 }
@@ -0,0 +1,372 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "raw_memory.h"
+#include "relocation.h"
+#include "simple_vector.h"
+
+// Вектор с тем же интерфейсом, что и SimpleVector, который хранит до N элементов
+// во встроенном буфере и обращается к куче, только когда элементов становится больше
+template <typename Type, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs a non-empty inline buffer");
+
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+public:
+
+    SmallVector() noexcept = default;
+
+    SmallVector(const ReserveProxyObj& reserve_obj) : SmallVector() {
+        Reserve(reserve_obj.value);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallVector(size_t size) : SmallVector() {
+        Reserve(size);
+        heap_.ConstructN(data_, size);
+        size_ = size;
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallVector(size_t size, const Type& value) : SmallVector() {
+        Reserve(size);
+        heap_.ConstructN(data_, size, value);
+        size_ = size;
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallVector(std::initializer_list<Type> init) : SmallVector() {
+        Reserve(init.size());
+        heap_.CopyConstructN(init.begin(), init.size(), data_);
+        size_ = init.size();
+    }
+
+    //Конструктор копирования
+    SmallVector(const SmallVector& other) : SmallVector() {
+        Reserve(other.size_);
+        heap_.CopyConstructN(other.data_, other.size_, data_);
+        size_ = other.size_;
+    }
+
+    //Конструктор перемещения. Буфер в куче забирается целиком,
+    //а элементы из встроенного буфера переносятся по одному
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) : SmallVector() {
+        MoveFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            SmallVector temp(other);
+            Clear();
+            MoveFrom(temp);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &other) {
+            Clear();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        heap_.DestroyN(data_, size_);
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива
+    size_t GetCapacity() const noexcept {
+        return IsInline() ? N : heap_.Capacity();
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, хранятся ли элементы во встроенном буфере
+    bool IsInline() const noexcept {
+        return heap_.Get() == nullptr;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        return data_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        return data_[index];
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        return const_cast<Type&>(
+                const_cast<const SmallVector*>(this)->At(index)
+        );
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        using namespace std::literals;
+        if (index >= size_) {
+            throw std::out_of_range("out of range"s);
+        }
+
+        return data_[index];
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость
+    void Clear() noexcept {
+        heap_.DestroyN(data_, size_);
+        size_ = 0;
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(const size_t new_size) {
+        if (new_size < size_) {
+            heap_.DestroyN(data_ + new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            Reserve(new_size);
+            heap_.ConstructN(data_ + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Переносит элементы в кучу, если new_capacity больше текущей вместимости
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= GetCapacity()) {
+            return;
+        }
+        if constexpr (RawMemory<Type>::kCanReallocate) {
+            if (!IsInline()) {
+                heap_.Reallocate(new_capacity);
+                data_ = heap_.Get();
+                return;
+            }
+        }
+        RawMemory<Type> new_heap(new_capacity);
+        heap_.RelocateN(data_, size_, new_heap.Get());
+        heap_.swap(new_heap);
+        data_ = heap_.Get();
+    }
+
+    void PushBack(const Type& value) {
+        EmplaceBack(value);
+    }
+
+    //Перемещающий push_back
+    void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    //Перемещающий insert
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент в конце массива из аргументов args, возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            return *Emplace(cend(), std::forward<Args>(args)...);
+        }
+        heap_.Construct(data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return data_[size_ - 1];
+    }
+
+    // Конструирует элемент из аргументов args перед позицией pos, возвращает итератор на него
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = pos - cbegin();
+        // args могут ссылаться на элемент вектора, поэтому объект создаётся
+        // во временной сырой ячейке до роста и сдвига
+        alignas(Type) unsigned char temp[sizeof(Type)];
+        Type* temp_obj = reinterpret_cast<Type*>(temp);
+        heap_.Construct(temp_obj, std::forward<Args>(args)...);
+        try {
+            if (size_ == GetCapacity()) {
+                Reserve(GrownCapacity());
+            }
+            if constexpr (kIsTriviallyRelocatable<Type>) {
+                RelocateOverlappingN(data_ + offset, size_ - offset, data_ + (offset + 1));
+                UninitializedRelocateN(temp_obj, 1, data_ + offset);
+                ++size_;
+                return data_ + offset;
+            } else if (offset == size_) {
+                heap_.Construct(data_ + size_, std::move(*temp_obj));
+                ++size_;
+            } else {
+                heap_.Construct(data_ + size_, std::move(data_[size_ - 1]));
+                // Новый последний элемент сразу входит в размер: если сдвиг бросит
+                // исключение, он будет разрушен вместе с остальными
+                ++size_;
+                std::move_backward(data_ + offset, data_ + size_ - 2, data_ + size_ - 1);
+                data_[offset] = std::move(*temp_obj);
+            }
+        } catch (...) {
+            heap_.Destroy(temp_obj);
+            throw;
+        }
+        heap_.Destroy(temp_obj);
+        return data_ + offset;
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t offset = pos - cbegin();
+        Iterator true_position = data_ + offset;
+        if constexpr (kIsTriviallyRelocatable<Type>) {
+            heap_.Destroy(true_position);
+            RelocateOverlappingN(true_position + 1, size_ - offset - 1, true_position);
+        } else {
+            std::move(true_position + 1, end(), true_position);
+            heap_.Destroy(end() - 1);
+        }
+        --size_;
+        return true_position;
+    }
+
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            heap_.Destroy(end() - 1);
+            --size_;
+        }
+    }
+
+    // Возвращает итератор на начало массива
+    Iterator begin() noexcept {
+        return data_;
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    Iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    // Возвращает константный итератор на начало массива
+    ConstIterator begin() const noexcept {
+        return cbegin();
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    ConstIterator end() const noexcept {
+        return cend();
+    }
+
+    // Возвращает константный итератор на начало массива
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    // Возвращает итератор на элемент, следующий за последним
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    // Обменивается содержимым с other. Если оба вектора в куче, обмениваются
+    // только указатели, иначе элементы переносятся через временный вектор
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (!IsInline() && !other.IsInline()) {
+            heap_.swap(other.heap_);
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return;
+        }
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+private:
+
+    //Встроенный буфер под N элементов
+    alignas(Type) unsigned char inline_buffer_[N * sizeof(Type)];
+
+    //Буфер в куче, пустой, пока элементы помещаются во встроенный буфер
+    RawMemory<Type> heap_ = {};
+
+    //Указатель на текущее хранилище: встроенный буфер или буфер в куче
+    Type* data_ = reinterpret_cast<Type*>(inline_buffer_);
+
+    //Размер массива
+    size_t size_ = 0;
+
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_buffer_);
+    }
+
+    size_t GrownCapacity() const noexcept {
+        return GetCapacity() * 2;
+    }
+
+    // Забирает элементы other, который остаётся пустым и возвращается во встроенный буфер.
+    // *this должен быть пуст
+    void MoveFrom(SmallVector& other) {
+        if (!other.IsInline()) {
+            heap_ = std::move(other.heap_);
+            data_ = heap_.Get();
+            size_ = std::exchange(other.size_, 0);
+            other.data_ = other.InlineData();
+            return;
+        }
+        // В собственном хранилище всегда найдётся место под N элементов
+        heap_.RelocateN(other.data_, other.size_, data_);
+        size_ = std::exchange(other.size_, 0);
+    }
+
+};
+
+
+template <typename Type, size_t N>
+bool operator==(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t N>
+bool operator!=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+bool operator<(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t N>
+bool operator>(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+bool operator<=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(lhs > rhs);
+}
+
+template <typename Type, size_t N>
+bool operator>=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(rhs > lhs);
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+#include "simple_span.h"
+#include "vector_checks.h"
+
+// Вектор записей из полей Ts..., в котором каждое поле хранится в собственном непрерывном
+// буфере (структура массивов). Цикл, читающий два поля из девяти, загружает в кэш только
+// эти два столбца, а столбцы арифметических типов просматриваются векторизованно:
+//
+//     SoaVector<float, float, int> particles;
+//     particles.PushBack({1.0f, 2.0f, 3});
+//     for (float& x : particles.Get<0>()) {
+//         x *= 2;
+//     }
+//
+// Столбцы имеют общие размер и вместимость и растут вместе. Строки адресуются индексами:
+// operator[] возвращает кортеж ссылок на поля строки. Изменение вместимости делает
+// недействительными столбцы, полученные через Get, как и итераторы SimpleVector
+template <typename... Ts>
+class SoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector needs at least one field");
+
+    using Columns = std::tuple<RawMemory<Ts>...>;
+
+    // Перенос столбца не бросает исключений, поэтому его можно отложить до конца перевыделения
+    template <typename Type>
+    static constexpr bool kNothrowRelocatable = kIsTriviallyRelocatable<Type>
+            || std::is_nothrow_move_constructible_v<Type>;
+
+public:
+
+    // Тип поля с номером I
+    template <size_t I>
+    using Field = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    using Row = std::tuple<Ts...>;
+
+    // Суммарный размер полей одной строки. По нему политика роста оценивает размер буфера
+    static constexpr size_t kRowSize = (sizeof(Ts) + ...);
+
+    SoaVector() noexcept = default;
+
+    // Создаёт size строк, поля которых инициализированы значением по умолчанию
+    explicit SoaVector(size_t size) {
+        Resize(size);
+    }
+
+    SoaVector(std::initializer_list<Row> init) {
+        Reserve(init.size());
+        for (const Row& row : init) {
+            PushBack(row);
+        }
+    }
+
+    SoaVector(const SoaVector& other) {
+        Reserve(other.size_);
+        ForEachFieldOrUndo([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns_).CopyConstructN(std::get<I>(other.columns_).Get(), other.size_,
+                                                 std::get<I>(columns_).Get());
+        }, [&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns_).DestroyN(std::get<I>(columns_).Get(), other.size_);
+        });
+        size_ = other.size_;
+    }
+
+    SoaVector(SoaVector&& other) noexcept {
+        swap(other);
+    }
+
+    SoaVector& operator=(const SoaVector& other) {
+        if (this != &other) {
+            SoaVector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    SoaVector& operator=(SoaVector&& other) noexcept {
+        if (this != &other) {
+            SoaVector temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    ~SoaVector() {
+        Clear();
+    }
+
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает столбец поля I. Он действителен до изменения вместимости
+    template <size_t I>
+    SimpleSpan<Field<I>> Get() noexcept {
+        return {std::get<I>(columns_).Get(), size_};
+    }
+
+    template <size_t I>
+    SimpleSpan<const Field<I>> Get() const noexcept {
+        return {std::get<I>(columns_).Get(), size_};
+    }
+
+    // Возвращает кортеж ссылок на поля строки index
+    // В проверяемом режиме index >= size считается ошибкой
+    std::tuple<Ts&...> operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return std::apply([index](auto&... column) {
+            return std::tuple<Ts&...>(column[index]...);
+        }, columns_);
+    }
+
+    std::tuple<const Ts&...> operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < size_, "index out of range");
+        return std::apply([index](const auto&... column) {
+            return std::tuple<const Ts&...>(column[index]...);
+        }, columns_);
+    }
+
+    // Удаляет все строки, не изменяя вместимость
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    // Изменяет размер. Поля новых строк инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size < size_) {
+            DestroyRows(new_size, size_ - new_size);
+        } else if (new_size > size_) {
+            if (new_size > capacity_) {
+                Reserve(GrownCapacity(new_size));
+            }
+            ForEachFieldOrUndo([&](auto field) {
+                auto& column = std::get<decltype(field)::value>(columns_);
+                column.ConstructN(column + size_, new_size - size_);
+            }, [&](auto field) {
+                auto& column = std::get<decltype(field)::value>(columns_);
+                column.DestroyN(column + size_, new_size - size_);
+            });
+        }
+        size_ = new_size;
+    }
+
+    // Выделяет все столбцы под new_capacity строк. Если перенос бросил исключение,
+    // вектор не изменяется
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        Columns new_columns{RawMemory<Ts>(new_capacity)...};
+        RelocateColumns(new_columns);
+        columns_.swap(new_columns);
+        capacity_ = new_capacity;
+    }
+
+    void PushBack(const Row& row) {
+        std::apply([this](const Ts&... fields) {
+            EmplaceBack(fields...);
+        }, row);
+    }
+
+    void PushBack(Row&& row) {
+        std::apply([this](Ts&... fields) {
+            EmplaceBack(std::move(fields)...);
+        }, row);
+    }
+
+    // Добавляет строку, конструируя каждое поле из соответствующего аргумента
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack takes one argument per field");
+        if (size_ == capacity_) {
+            const size_t new_capacity = GrownCapacity(size_ + 1);
+            Columns new_columns{RawMemory<Ts>(new_capacity)...};
+            // Новая строка создаётся до переноса старых, так как args могут ссылаться на одну из них
+            ConstructRow(new_columns, size_, std::forward<Args>(args)...);
+            try {
+                RelocateColumns(new_columns);
+            } catch (...) {
+                DestroyRow(new_columns, size_);
+                throw;
+            }
+            columns_.swap(new_columns);
+            capacity_ = new_capacity;
+        } else {
+            ConstructRow(columns_, size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        if (size_ > 0) {
+            DestroyRow(columns_, size_ - 1);
+            --size_;
+        }
+    }
+
+    // Удаляет строку index, сдвигая следующие
+    void Erase(size_t index) {
+        Erase(index, index + 1);
+    }
+
+    // Удаляет строки [first, last) за один сдвиг каждого столбца. Если присваивание
+    // поля бросило исключение, размер не меняется, но строки могут оказаться перемешаны
+    void Erase(size_t first, size_t last) {
+        SIMPLE_VECTOR_CHECK(first <= last && last <= size_, "erased rows out of range");
+        const size_t count = last - first;
+        if (count == 0) {
+            return;
+        }
+        ForEachField([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            auto& column = std::get<I>(columns_);
+            if constexpr (kIsTriviallyRelocatable<Field<I>>) {
+                column.DestroyN(column + first, count);
+                RelocateOverlappingN(column + last, size_ - last, column + first);
+            } else {
+                std::move(column + last, column + size_, column + first);
+                column.DestroyN(column + (size_ - count), count);
+            }
+        });
+        size_ -= count;
+    }
+
+    void swap(SoaVector& other) noexcept {
+        columns_.swap(other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+private:
+
+    // Столбцы полей. Сконструированы только первые size_ ячеек каждого
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+
+    // Вызывает fn(std::integral_constant<size_t, I>) для каждого поля I по порядку
+    template <typename Fn>
+    static void ForEachField(Fn fn) {
+        ForEachField(fn, std::index_sequence_for<Ts...>());
+    }
+
+    template <typename Fn, size_t... I>
+    static void ForEachField(Fn& fn, std::index_sequence<I...>) {
+        (fn(std::integral_constant<size_t, I>()), ...);
+    }
+
+    // Вызывает apply для каждого поля. Если apply бросил исключение, для уже
+    // обработанных полей вызывается undo, и исключение пробрасывается дальше
+    template <typename Apply, typename Undo>
+    static void ForEachFieldOrUndo(Apply apply, Undo undo) {
+        size_t done = 0;
+        try {
+            ForEachField([&](auto field) {
+                apply(field);
+                ++done;
+            });
+        } catch (...) {
+            ForEachField([&](auto field) {
+                if (decltype(field)::value < done) {
+                    undo(field);
+                }
+            });
+            throw;
+        }
+    }
+
+    // Конструирует поля строки index в неинициализированных ячейках columns
+    template <typename... Args>
+    static void ConstructRow(Columns& columns, size_t index, Args&&... args) {
+        auto arguments = std::forward_as_tuple(std::forward<Args>(args)...);
+        ForEachFieldOrUndo([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns).Construct(std::get<I>(columns) + index, std::get<I>(std::move(arguments)));
+        }, [&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns).Destroy(std::get<I>(columns) + index);
+        });
+    }
+
+    static void DestroyRow(Columns& columns, size_t index) noexcept {
+        ForEachField([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns).Destroy(std::get<I>(columns) + index);
+        });
+    }
+
+    void DestroyRows(size_t first, size_t count) noexcept {
+        ForEachField([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            std::get<I>(columns_).DestroyN(std::get<I>(columns_) + first, count);
+        });
+    }
+
+    // Переносит строки в столбцы to. Столбцы, перенос которых может бросить исключение,
+    // сначала копируются, а остальные переносятся только после этого, поэтому
+    // при исключении *this не изменяется
+    void RelocateColumns(Columns& to) {
+        ForEachFieldOrUndo([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            if constexpr (!kNothrowRelocatable<Field<I>>) {
+                std::get<I>(to).MoveOrCopyConstructN(std::get<I>(columns_).Get(), size_, std::get<I>(to).Get());
+            }
+        }, [&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            if constexpr (!kNothrowRelocatable<Field<I>>) {
+                std::get<I>(to).DestroyN(std::get<I>(to).Get(), size_);
+            }
+        });
+        ForEachField([&](auto field) {
+            constexpr size_t I = decltype(field)::value;
+            if constexpr (kNothrowRelocatable<Field<I>>) {
+                std::get<I>(columns_).RelocateN(std::get<I>(columns_).Get(), size_, std::get<I>(to).Get());
+            } else {
+                std::get<I>(columns_).DestroyN(std::get<I>(columns_).Get(), size_);
+            }
+        });
+    }
+
+    // Вместимость после роста, когда должно поместиться required строк
+    size_t GrownCapacity(size_t required) const noexcept {
+        return std::max(DoublingGrowth::NextCapacity(capacity_, required, kRowSize), required);
+    }
+
+};
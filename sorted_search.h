@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "simd_kernels.h"
+#include "simple_vector.h"
+
+// Поиск в отсортированном массиве для FlatSet и FlatMap. Раскладка выбирается параметром
+// шаблона контейнера:
+//
+//     FlatSet<int> ids;                                    // двоичный поиск по массиву ключей
+//     FlatSet<int, std::less<int>, EytzingerLayout> table; // копия ключей в порядке Эйтцингера
+//
+// Раскладка — тип с вложенным шаблоном Index<Key, Allocator>, который создаётся по
+// умолчанию или из аллокатора контейнера, и у которого есть методы
+// Build(sorted, n), вызываемый после каждого изменения ключей, и
+// LowerBound(sorted, n, key, less), возвращающий индекс первого ключа не меньше key.
+// Если Build выбросил исключение, LowerBound всё равно должен оставаться в границах n
+
+// Возвращает индекс первого из n ключей sorted, не меньшего key. Цикл не содержит
+// условных переходов: выбор половины компилируется в условную пересылку, поэтому
+// промахи предсказателя ветвлений не зависят от искомого ключа
+template <typename Key, typename Compare>
+size_t BranchlessLowerBound(const Key* sorted, size_t n, const Key& key, const Compare& less) {
+    if (n == 0) {
+        return 0;
+    }
+    const Key* base = sorted;
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = less(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - sorted) + static_cast<size_t>(less(*base, key));
+}
+
+// Двоичный поиск без ветвлений по отсортированному массиву. Не требует памяти сверх ключей
+struct SortedLayout {
+    template <typename Key, typename Allocator>
+    class Index {
+    public:
+        Index() = default;
+
+        explicit Index(const Allocator& /*allocator*/) noexcept {
+        }
+
+        void Build(const Key* /*sorted*/, size_t /*n*/) noexcept {
+        }
+
+        template <typename Compare>
+        size_t LowerBound(const Key* sorted, size_t n, const Key& key, const Compare& less) const {
+            return BranchlessLowerBound(sorted, n, key, less);
+        }
+    };
+};
+
+// Хранит копию ключей в порядке обхода двоичного дерева в ширину (раскладка Эйтцингера):
+// потомки узла k — узлы 2k и 2k + 1. Первые уровни дерева занимают несколько строк кэша
+// и всегда горячие, а узлы следующих уровней подгружаются заранее, поэтому поиск в
+// больших таблицах быстрее двоичного. Занимает дополнительно n ключей и n индексов,
+// перестраивается за O(n) при каждом изменении
+struct EytzingerLayout {
+    template <typename Key, typename Allocator>
+    class Index {
+        using RankAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<size_t>;
+
+    public:
+        Index() = default;
+
+        explicit Index(const Allocator& allocator) noexcept
+                : tree_(allocator)
+                , ranks_(RankAllocator(allocator)) {
+        }
+
+        // Перестраивает индекс на месте, повторно используя память tree_ и ranks_.
+        // Если копирование ключа бросит исключение, индекс очищается, и LowerBound
+        // переходит на двоичный поиск по sorted
+        void Build(const Key* sorted, size_t n) {
+            if (n == 0) {
+                tree_.Clear();
+                ranks_.Clear();
+                return;
+            }
+            try {
+                ranks_.Resize(n + 1);
+                FillRanks(1, 0, n, ranks_.Data());
+                // Узел 0 означает, что все ключи меньше искомого
+                ranks_[0] = n;
+                if (tree_.GetSize() > n) {
+                    tree_.Erase(tree_.cbegin() + n, tree_.cend());
+                }
+                const size_t reused = tree_.GetSize();
+                for (size_t k = 1; k <= reused; ++k) {
+                    tree_[k - 1] = sorted[ranks_[k]];
+                }
+                tree_.Reserve(n);
+                for (size_t k = reused + 1; k <= n; ++k) {
+                    tree_.PushBack(sorted[ranks_[k]]);
+                }
+            } catch (...) {
+                tree_.Clear();
+                ranks_.Clear();
+                throw;
+            }
+        }
+
+        template <typename Compare>
+        size_t LowerBound(const Key* sorted, size_t n, const Key& key, const Compare& less) const {
+            // Индекс не соответствует ключам, если последний Build не удался
+            if (tree_.GetSize() != n) {
+                return BranchlessLowerBound(sorted, n, key, less);
+            }
+            if (n == 0) {
+                return 0;
+            }
+            const Key* tree = tree_.Data();
+            const size_t size = tree_.GetSize();
+            size_t k = 1;
+            while (k <= size) {
+#if defined(__GNUC__) || defined(__clang__)
+                // Через четыре уровня поиск окажется среди 16 соседних потомков узла k
+                __builtin_prefetch(reinterpret_cast<const void*>(
+                        reinterpret_cast<uintptr_t>(tree) + (16 * k - 1) * sizeof(Key)));
+#endif
+                k = 2 * k + static_cast<size_t>(less(tree[k - 1], key));
+            }
+            // Отбрасываем спуски вправо после последнего спуска влево: это и есть ответ
+            k >>= simd::detail::CountTrailingZeros(~static_cast<uint64_t>(k)) + 1;
+            return ranks_[k];
+        }
+
+    private:
+        // Ключи узлов 1..n в порядке Эйтцингера
+        SimpleVector<Key, Allocator> tree_;
+        // Индекс ключа узла k в отсортированном массиве
+        SimpleVector<size_t, RankAllocator> ranks_;
+
+        // Нумерует узлы поддерева k в симметричном порядке, начиная с rank
+        static size_t FillRanks(size_t k, size_t rank, size_t n, size_t* ranks) noexcept {
+            if (k > n) {
+                return rank;
+            }
+            rank = FillRanks(2 * k, rank, n, ranks);
+            ranks[k] = rank++;
+            return FillRanks(2 * k + 1, rank, n, ranks);
+        }
+    };
+};
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "vector_checks.h"
+#include "vector_constexpr.h"
+
+// Ячейки StaticVector. Для тривиальных типов это обычный массив: StaticVector тогда
+// тривиально копируется и разрушается и может быть constexpr-переменной
+template <typename Type, size_t N, bool = std::is_trivially_default_constructible_v<Type>
+                                         && std::is_trivially_copyable_v<Type>>
+struct StaticVectorStorage {
+    Type cells[N];
+    size_t size = 0;
+
+    SIMPLE_VECTOR_CONSTEXPR StaticVectorStorage() noexcept {
+        // Результат константного выражения не может содержать неинициализированных ячеек
+        if (IsConstantEvaluated()) {
+            for (Type& cell : cells) {
+                ConstructAt(&cell);
+            }
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type* Cells() noexcept {
+        return cells;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* Cells() const noexcept {
+        return cells;
+    }
+};
+
+// Сырая память под N элементов остальных типов. Копируются и разрушаются только
+// первые size элементов
+template <typename Type, size_t N>
+struct StaticVectorStorage<Type, N, false> {
+    alignas(Type) unsigned char bytes[sizeof(Type) * N];
+    size_t size = 0;
+
+    StaticVectorStorage() noexcept {
+    }
+
+    StaticVectorStorage(const StaticVectorStorage& other) {
+        std::uninitialized_copy_n(other.Cells(), other.size, Cells());
+        size = other.size;
+    }
+
+    StaticVectorStorage(StaticVectorStorage&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        std::uninitialized_move_n(other.Cells(), other.size, Cells());
+        size = other.size;
+    }
+
+    StaticVectorStorage& operator=(const StaticVectorStorage& other) {
+        if (this != &other) {
+            AssignFrom(other.Cells(), other.size);
+        }
+        return *this;
+    }
+
+    StaticVectorStorage& operator=(StaticVectorStorage&& other) noexcept(std::is_nothrow_move_assignable_v<Type>
+                                                                          && std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &other) {
+            AssignFrom(std::make_move_iterator(other.Cells()), other.size);
+        }
+        return *this;
+    }
+
+    ~StaticVectorStorage() {
+        std::destroy_n(Cells(), size);
+    }
+
+    Type* Cells() noexcept {
+        return std::launder(reinterpret_cast<Type*>(bytes));
+    }
+
+    const Type* Cells() const noexcept {
+        return std::launder(reinterpret_cast<const Type*>(bytes));
+    }
+
+    // Присваивает count элементов from поверх имеющихся, недостающие конструирует, лишние разрушает
+    template <typename It>
+    void AssignFrom(It from, size_t count) {
+        Type* cells = Cells();
+        const size_t common = std::min(size, count);
+        std::copy_n(from, common, cells);
+        if (count > size) {
+            std::uninitialized_copy_n(std::next(from, common), count - common, cells + common);
+        } else {
+            std::destroy_n(cells + count, size - count);
+        }
+        size = count;
+    }
+};
+
+// Вектор вместимостью ровно N элементов, хранящихся внутри объекта. Куча не используется
+// никогда, поэтому StaticVector подходит для горячих путей и систем без динамической памяти:
+//
+//     StaticVector<Event, 16> pending;
+//     pending.PushBack(event);
+//
+// Добавление в заполненный вектор бросает std::length_error. В C++20 все операции для
+// тривиальных типов доступны в константных выражениях, и таблицу можно вычислить
+// при компиляции (см. vector_constexpr.h):
+//
+//     constexpr StaticVector<int, 4> kPrimes = {2, 3, 5, 7};
+template <typename Type, size_t N>
+class StaticVector {
+    static_assert(N > 0, "StaticVector needs a positive capacity");
+
+public:
+
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    SIMPLE_VECTOR_CONSTEXPR StaticVector() noexcept = default;
+
+    // Создаёт size элементов, инициализированных значением по умолчанию
+    SIMPLE_VECTOR_CONSTEXPR explicit StaticVector(size_t size) {
+        Resize(size);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR StaticVector(size_t size, const Type& value) {
+        CheckFits(size);
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(value);
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR StaticVector(std::initializer_list<Type> init) {
+        CheckFits(init.size());
+        for (const Type& item : init) {
+            EmplaceBack(item);
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+        return storage_.size;
+    }
+
+    static constexpr size_t GetCapacity() noexcept {
+        return N;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
+        return storage_.size == 0;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR bool IsFull() const noexcept {
+        return storage_.size == N;
+    }
+
+    // В проверяемом режиме index >= size считается ошибкой
+    SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < storage_.size, "index out of range");
+        return storage_.Cells()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept(!kVectorChecked) {
+        SIMPLE_VECTOR_CHECK(index < storage_.size, "index out of range");
+        return storage_.Cells()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
+        if (index >= storage_.size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return storage_.Cells()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
+        if (index >= storage_.size) {
+            throw std::out_of_range("Index out of range");
+        }
+        return storage_.Cells()[index];
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Type* Data() noexcept {
+        return storage_.Cells();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR const Type* Data() const noexcept {
+        return storage_.Cells();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+        std::destroy_n(storage_.Cells(), storage_.size);
+        storage_.size = 0;
+    }
+
+    // Изменяет размер. Новые элементы инициализируются значением по умолчанию
+    SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+        CheckFits(new_size);
+        while (storage_.size > new_size) {
+            PopBack();
+        }
+        while (storage_.size < new_size) {
+            EmplaceBack();
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type& value) {
+        EmplaceBack(value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PushBack(Type&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    // Конструирует элемент в конце. Если вектор заполнен, бросает std::length_error
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+        CheckFits(storage_.size + 1);
+        Type* place = ConstructAt(storage_.Cells() + storage_.size, std::forward<Args>(args)...);
+        ++storage_.size;
+        return *place;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
+        if (storage_.size > 0) {
+            --storage_.size;
+            std::destroy_at(storage_.Cells() + storage_.size);
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Конструирует элемент перед pos, сдвигая хвост. Если вектор заполнен, бросает std::length_error
+    template <typename... Args>
+    SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator pos, Args&&... args) {
+        const size_t offset = OffsetOf(pos);
+        CheckFits(storage_.size + 1);
+        Type* cells = storage_.Cells();
+        const size_t size = storage_.size;
+        if (offset == size) {
+            ConstructAt(cells + size, std::forward<Args>(args)...);
+            ++storage_.size;
+        } else {
+            // args могут ссылаться на элемент вектора, поэтому объект создаётся до сдвига
+            Type temp(std::forward<Args>(args)...);
+            ConstructAt(cells + size, std::move(cells[size - 1]));
+            ++storage_.size;
+            std::move_backward(cells + offset, cells + (size - 1), cells + size);
+            cells[offset] = std::move(temp);
+        }
+        return cells + offset;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator pos) {
+        SIMPLE_VECTOR_CHECK(OffsetOf(pos) < storage_.size, "erasing the end iterator");
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last) и возвращает итератор на следовавший за ними
+    SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t offset = OffsetOf(first);
+        const size_t last_offset = OffsetOf(last);
+        SIMPLE_VECTOR_CHECK(offset <= last_offset, "erasing a reversed range");
+        Type* cells = storage_.Cells();
+        Type* new_end = std::move(cells + last_offset, cells + storage_.size, cells + offset);
+        std::destroy(new_end, cells + storage_.size);
+        storage_.size -= last_offset - offset;
+        return cells + offset;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
+        return storage_.Cells();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
+        return storage_.Cells() + storage_.size;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
+        return storage_.Cells();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
+        return storage_.Cells() + storage_.size;
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+
+    StaticVectorStorage<Type, N> storage_;
+
+    static SIMPLE_VECTOR_CONSTEXPR void CheckFits(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    SIMPLE_VECTOR_CONSTEXPR size_t OffsetOf(ConstIterator pos) const noexcept(!kVectorChecked) {
+        const size_t offset = static_cast<size_t>(pos - storage_.Cells());
+        SIMPLE_VECTOR_CHECK(offset <= storage_.size, "iterator does not point into the vector");
+        return offset;
+    }
+
+};
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator==(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator!=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator<(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator>(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator<=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N>
+SIMPLE_VECTOR_CONSTEXPR bool operator>=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+
+#include "vector_constexpr.h"
+
+// Проверяемый режим SimpleVector. Включается макросом SIMPLE_VECTOR_CHECKED, заданным
+// до подключения заголовков (например, -DSIMPLE_VECTOR_CHECKED). В нём operator[]
+// проверяет индекс, а итераторы помнят свой вектор и число перевыделений его буфера
+// на момент создания: разыменование итератора за пределами элементов, после Reserve
+// или другого перевыделения, а также передача в Insert/Erase чужого или устаревшего
+// итератора считаются ошибкой. Без макроса итераторы остаются указателями, а проверки
+// не порождают ни одной инструкции.
+//
+// При ошибке вызывается обработчик, заданный SetCheckFailureHandler. По умолчанию он
+// печатает сообщение в stderr и вызывает std::abort
+
+#ifdef SIMPLE_VECTOR_CHECKED
+inline constexpr bool kVectorChecked = true;
+#define SIMPLE_VECTOR_CHECK(condition, message) \
+    ((condition) ? static_cast<void>(0) : CheckFailed(message))
+#else
+inline constexpr bool kVectorChecked = false;
+#define SIMPLE_VECTOR_CHECK(condition, message) static_cast<void>(0)
+#endif
+
+// Обработчик проваленной проверки. Может бросить исключение; если он вернёт
+// управление, программа всё равно будет аварийно завершена
+using CheckFailureHandler = void (*)(const char* message);
+
+inline void DefaultCheckFailureHandler(const char* message) {
+    std::fprintf(stderr, "SimpleVector check failed: %s\n", message);
+}
+
+inline CheckFailureHandler& CheckFailureHandlerSetting() noexcept {
+    static CheckFailureHandler handler = DefaultCheckFailureHandler;
+    return handler;
+}
+
+// Заменяет обработчик и возвращает прежний. nullptr восстанавливает обработчик по умолчанию
+inline CheckFailureHandler SetCheckFailureHandler(CheckFailureHandler handler) noexcept {
+    CheckFailureHandler previous = CheckFailureHandlerSetting();
+    CheckFailureHandlerSetting() = handler != nullptr ? handler : DefaultCheckFailureHandler;
+    return previous;
+}
+
+[[noreturn]] inline void CheckFailed(const char* message) {
+    CheckFailureHandlerSetting()(message);
+    std::abort();
+}
+
+// Счётчик перевыделений буфера вектора. В проверяемом режиме итераторы сравнивают
+// его с сохранённым значением, иначе он пуст и не занимает места в векторе
+struct VectorGeneration {
+#ifdef SIMPLE_VECTOR_CHECKED
+    size_t value = 0;
+
+    SIMPLE_VECTOR_CONSTEXPR void Advance() noexcept {
+        ++value;
+    }
+#else
+    SIMPLE_VECTOR_CONSTEXPR void Advance() noexcept {
+    }
+#endif
+};
+
+// Итератор произвольного доступа проверяемого режима. Хранит указатель на элемент,
+// начало буфера и адреса размера и счётчика перевыделений своего вектора.
+// Арифметика не проверяется, как и у указателя: проверяются разыменование,
+// разность итераторов и передача итератора в функции вектора
+template <typename Type>
+class CheckedIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_const_t<Type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Type*;
+    using reference = Type&;
+
+    CheckedIterator() noexcept = default;
+
+    CheckedIterator(Type* ptr, Type* first, const size_t* size, const size_t* generation) noexcept
+            : ptr_(ptr)
+            , first_(first)
+            , size_(size)
+            , generation_(generation)
+            , snapshot_(*generation) {
+    }
+
+    // Неконстантный итератор преобразуется в константный
+    template <typename Other, typename = std::enable_if_t<std::is_same_v<const Other, Type>
+                                                          && !std::is_same_v<Other, Type>>>
+    CheckedIterator(const CheckedIterator<Other>& other) noexcept
+            : ptr_(other.ptr_)
+            , first_(other.first_)
+            , size_(other.size_)
+            , generation_(other.generation_)
+            , snapshot_(other.snapshot_) {
+    }
+
+    // Возвращает указатель без проверок
+    Type* Base() const noexcept {
+        return ptr_;
+    }
+
+    // Сообщает, создан ли итератор вектором с этим счётчиком и не перевыделялся ли с тех пор буфер
+    bool IsCurrent(const size_t* generation) const noexcept {
+        return generation_ == generation && *generation_ == snapshot_;
+    }
+
+    reference operator*() const {
+        CheckDereferenceable();
+        return *ptr_;
+    }
+
+    pointer operator->() const {
+        CheckDereferenceable();
+        return ptr_;
+    }
+
+    reference operator[](difference_type offset) const {
+        return *(*this + offset);
+    }
+
+    CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator++(int) noexcept {
+        CheckedIterator copy = *this;
+        ++ptr_;
+        return copy;
+    }
+
+    CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator--(int) noexcept {
+        CheckedIterator copy = *this;
+        --ptr_;
+        return copy;
+    }
+
+    CheckedIterator& operator+=(difference_type offset) noexcept {
+        ptr_ += offset;
+        return *this;
+    }
+
+    CheckedIterator& operator-=(difference_type offset) noexcept {
+        ptr_ -= offset;
+        return *this;
+    }
+
+    friend CheckedIterator operator+(CheckedIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend CheckedIterator operator+(difference_type offset, CheckedIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend CheckedIterator operator-(CheckedIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        CheckSameVector(lhs, rhs);
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    friend bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend bool operator!=(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ != rhs.ptr_;
+    }
+
+    friend bool operator<(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        CheckSameVector(lhs, rhs);
+        return lhs.ptr_ < rhs.ptr_;
+    }
+
+    friend bool operator>(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        return !(lhs < rhs);
+    }
+
+private:
+    template <typename Other>
+    friend class CheckedIterator;
+
+    Type* ptr_ = nullptr;
+    Type* first_ = nullptr;
+    const size_t* size_ = nullptr;
+    const size_t* generation_ = nullptr;
+    size_t snapshot_ = 0;
+
+    void CheckDereferenceable() const {
+        SIMPLE_VECTOR_CHECK(generation_ != nullptr, "dereferencing a singular iterator");
+        SIMPLE_VECTOR_CHECK(*generation_ == snapshot_, "dereferencing an iterator invalidated by reallocation");
+        SIMPLE_VECTOR_CHECK(first_ <= ptr_ && ptr_ < first_ + *size_, "dereferencing an out of range iterator");
+    }
+
+    static void CheckSameVector(const CheckedIterator& lhs, const CheckedIterator& rhs) {
+        SIMPLE_VECTOR_CHECK(lhs.generation_ == rhs.generation_, "comparing iterators of different vectors");
+    }
+};
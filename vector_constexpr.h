@@ -0,0 +1,57 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+// Поддержка константных выражений. В C++20 (динамическая память в constexpr,
+// std::construct_at и std::is_constant_evaluated) основные операции SimpleVector
+// и StaticVector помечены constexpr, и таблицы можно строить при компиляции:
+//
+//     constexpr int kSum = [] {
+//         SimpleVector<int> squares;
+//         for (int i = 0; i < 10; ++i) {
+//             squares.PushBack(i * i);
+//         }
+//         return squares[9];
+//     }();
+//
+// Память, выделенная SimpleVector в константном выражении, должна освобождаться в нём же,
+// поэтому результат переносится в StaticVector, std::array или скаляр. В константном
+// выражении вместо memcpy, realloc и параллельного заполнения используются поэлементные
+// циклы, а счётчики vector_stats.h не ведутся. В C++17 SIMPLE_VECTOR_CONSTEXPR пуст
+
+#if defined(__cpp_constexpr_dynamic_alloc) && defined(__cpp_lib_constexpr_dynamic_alloc) \
+        && defined(__cpp_lib_is_constant_evaluated)
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 1
+inline constexpr bool kVectorConstexpr = true;
+#else
+#define SIMPLE_VECTOR_CONSTEXPR
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 0
+inline constexpr bool kVectorConstexpr = false;
+#endif
+
+// Сообщает, вычисляется ли вызов в константном выражении. До C++20 всегда false
+constexpr bool IsConstantEvaluated() noexcept {
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+    return std::is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+// Конструирует объект в неинициализированной ячейке place. В C++20 допустимо в constexpr
+template <typename Type, typename... Args>
+SIMPLE_VECTOR_CONSTEXPR Type* ConstructAt(Type* place, Args&&... args) {
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+    return std::construct_at(place, std::forward<Args>(args)...);
+#else
+    return ::new (static_cast<void*>(place)) Type(std::forward<Args>(args)...);
+#endif
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "vector_constexpr.h"
+
+// Счётчики выделений памяти и перемещений элементов SimpleVector и ArrayPtr.
+// Включаются макросом SIMPLE_VECTOR_STATS, заданным до подключения заголовков
+// (например, -DSIMPLE_VECTOR_STATS). Без него функции Record* пусты и после
+// встраивания не оставляют в коде ни одной инструкции.
+//
+// Счётчики ведутся отдельно для каждого типа элементов и суммарно:
+//
+//     VectorStatsSnapshot ints = GetVectorStats<int>();
+//     VectorStatsSnapshot all = GetGlobalVectorStats();
+
+#ifdef SIMPLE_VECTOR_STATS
+inline constexpr bool kVectorStatsEnabled = true;
+#else
+inline constexpr bool kVectorStatsEnabled = false;
+#endif
+
+// Значения счётчиков на момент запроса
+struct VectorStatsSnapshot {
+    // Число выделений буферов, включая realloc
+    uint64_t allocations = 0;
+    // Суммарный объём выделенных буферов в байтах
+    uint64_t bytes_allocated = 0;
+    // Число перевыделений буфера при росте вместимости
+    uint64_t regrowths = 0;
+    // Число элементов, перемещённых при росте, вставке и удалении
+    uint64_t element_moves = 0;
+    // Число скопированных элементов, в том числе при копировании векторов
+    uint64_t element_copies = 0;
+    // Наибольшая вместимость, которой достигал вектор
+    uint64_t peak_capacity = 0;
+};
+
+class VectorStats {
+public:
+    void AddAllocation(size_t bytes) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_allocated_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void AddRegrowth(size_t new_capacity) noexcept {
+        regrowths_.fetch_add(1, std::memory_order_relaxed);
+        UpdatePeakCapacity(new_capacity);
+    }
+
+    void AddMoves(size_t count) noexcept {
+        element_moves_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void AddCopies(size_t count) noexcept {
+        element_copies_.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void UpdatePeakCapacity(size_t capacity) noexcept {
+        uint64_t peak = peak_capacity_.load(std::memory_order_relaxed);
+        while (peak < capacity
+               && !peak_capacity_.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+        }
+    }
+
+    VectorStatsSnapshot Snapshot() const noexcept {
+        VectorStatsSnapshot snapshot;
+        snapshot.allocations = allocations_.load(std::memory_order_relaxed);
+        snapshot.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed);
+        snapshot.regrowths = regrowths_.load(std::memory_order_relaxed);
+        snapshot.element_moves = element_moves_.load(std::memory_order_relaxed);
+        snapshot.element_copies = element_copies_.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = peak_capacity_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+    void Reset() noexcept {
+        allocations_.store(0, std::memory_order_relaxed);
+        bytes_allocated_.store(0, std::memory_order_relaxed);
+        regrowths_.store(0, std::memory_order_relaxed);
+        element_moves_.store(0, std::memory_order_relaxed);
+        element_copies_.store(0, std::memory_order_relaxed);
+        peak_capacity_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> allocations_{0};
+    std::atomic<uint64_t> bytes_allocated_{0};
+    std::atomic<uint64_t> regrowths_{0};
+    std::atomic<uint64_t> element_moves_{0};
+    std::atomic<uint64_t> element_copies_{0};
+    std::atomic<uint64_t> peak_capacity_{0};
+};
+
+// Счётчики векторов с элементами типа Type
+template <typename Type>
+VectorStats& TypeVectorStats() noexcept {
+    static VectorStats stats;
+    return stats;
+}
+
+// Суммарные счётчики всех векторов
+inline VectorStats& GlobalVectorStats() noexcept {
+    static VectorStats stats;
+    return stats;
+}
+
+template <typename Type>
+VectorStatsSnapshot GetVectorStats() noexcept {
+    return TypeVectorStats<Type>().Snapshot();
+}
+
+inline VectorStatsSnapshot GetGlobalVectorStats() noexcept {
+    return GlobalVectorStats().Snapshot();
+}
+
+// Обнуляет счётчики типа Type. Суммарные счётчики не меняются
+template <typename Type>
+void ResetVectorStats() noexcept {
+    TypeVectorStats<Type>().Reset();
+}
+
+inline void ResetGlobalVectorStats() noexcept {
+    GlobalVectorStats().Reset();
+}
+
+// Точки учёта, которые вызывают контейнеры. В константных выражениях они ничего не делают
+
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RecordAllocation(size_t bytes) noexcept {
+    if constexpr (kVectorStatsEnabled) {
+        if (!IsConstantEvaluated()) {
+            TypeVectorStats<Type>().AddAllocation(bytes);
+            GlobalVectorStats().AddAllocation(bytes);
+        }
+    }
+}
+
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RecordRegrowth(size_t new_capacity) noexcept {
+    if constexpr (kVectorStatsEnabled) {
+        if (!IsConstantEvaluated()) {
+            TypeVectorStats<Type>().AddRegrowth(new_capacity);
+            GlobalVectorStats().AddRegrowth(new_capacity);
+        }
+    }
+}
+
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RecordCapacity(size_t capacity) noexcept {
+    if constexpr (kVectorStatsEnabled) {
+        if (!IsConstantEvaluated()) {
+            TypeVectorStats<Type>().UpdatePeakCapacity(capacity);
+            GlobalVectorStats().UpdatePeakCapacity(capacity);
+        }
+    }
+}
+
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RecordMoves(size_t count) noexcept {
+    if constexpr (kVectorStatsEnabled) {
+        if (!IsConstantEvaluated()) {
+            TypeVectorStats<Type>().AddMoves(count);
+            GlobalVectorStats().AddMoves(count);
+        }
+    }
+}
+
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RecordCopies(size_t count) noexcept {
+    if constexpr (kVectorStatsEnabled) {
+        if (!IsConstantEvaluated()) {
+            TypeVectorStats<Type>().AddCopies(count);
+            GlobalVectorStats().AddCopies(count);
+        }
+    }
+}